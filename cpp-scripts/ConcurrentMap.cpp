@@ -0,0 +1,799 @@
+```cpp
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <functional>
+#include <stdexcept>
+#include <algorithm>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace std;
+
+//---------------------------------------------------------------------------
+// Hazard pointers (compact copy from LockFreeLinkedList.cpp)
+//---------------------------------------------------------------------------
+
+// A reader publishes the address it is about to use in a hazard slot; a
+// writer retires removed objects instead of deleting them, and a retired
+// object is only freed once no slot points at it.
+class HazardPointers {
+public:
+    static constexpr size_t maxThreads = 128;
+    static constexpr size_t slotsPerThread = 2;
+
+    static HazardPointers &instance() {
+        static HazardPointers domain;
+        return domain;
+    }
+
+    ~HazardPointers() {
+        for (Retired &item : m_orphans) {
+            item.destroy(item.pointer);
+        }
+    }
+
+    template <typename T>
+    T *protect(size_t slot, const atomic<T *> &source) {
+        atomic<void *> &hazard = local().record->slots[slot];
+        T *pointer = source.load();
+        while (true) {
+            hazard.store(pointer);
+            T *again = source.load();
+            if (again == pointer) {
+                return pointer;
+            }
+            pointer = again;
+        }
+    }
+
+    void set(size_t slot, void *pointer) {
+        local().record->slots[slot].store(pointer);
+    }
+
+    void clear() {
+        for (auto &slot : local().record->slots) {
+            slot.store(nullptr, memory_order_release);
+        }
+    }
+
+    template <typename T>
+    void retire(T *pointer) {
+        ThreadState &state = local();
+        state.retired.push_back({pointer, [](void *p) { delete static_cast<T *>(p); }});
+        if (state.retired.size() >= 2 * maxThreads * slotsPerThread) {
+            scan(state.retired);
+        }
+    }
+
+private:
+    struct Retired {
+        void *pointer;
+        void (*destroy)(void *);
+    };
+
+    struct alignas(64) Record {
+        atomic<bool> active{false};
+        atomic<void *> slots[slotsPerThread] = {};
+    };
+
+    struct ThreadState {
+        Record *record = nullptr;
+        vector<Retired> retired;
+
+        ~ThreadState() {
+            HazardPointers &domain = instance();
+            domain.scan(retired);
+            {
+                lock_guard<mutex> lock(domain.m_orphanMutex);
+                domain.m_orphans.insert(domain.m_orphans.end(), retired.begin(), retired.end());
+            }
+            for (auto &slot : record->slots) {
+                slot.store(nullptr);
+            }
+            record->active.store(false, memory_order_release);
+        }
+    };
+
+    Record m_records[maxThreads];
+    mutex m_orphanMutex;
+    vector<Retired> m_orphans;
+
+    ThreadState &local() {
+        thread_local ThreadState state;
+        if (state.record == nullptr) {
+            for (Record &record : m_records) {
+                bool expected = false;
+                if (!record.active.load(memory_order_relaxed) &&
+                    record.active.compare_exchange_strong(expected, true, memory_order_acquire)) {
+                    state.record = &record;
+                    break;
+                }
+            }
+            if (state.record == nullptr) {
+                cerr << "More than " << maxThreads << " threads use hazard pointers" << endl;
+                abort();
+            }
+        }
+        return state;
+    }
+
+    void scan(vector<Retired> &retired) {
+        {
+            unique_lock<mutex> lock(m_orphanMutex, try_to_lock);
+            if (lock.owns_lock() && !m_orphans.empty()) {
+                retired.insert(retired.end(), m_orphans.begin(), m_orphans.end());
+                m_orphans.clear();
+            }
+        }
+        vector<void *> hazards;
+        for (Record &record : m_records) {
+            for (auto &slot : record.slots) {
+                if (void *pointer = slot.load()) {
+                    hazards.push_back(pointer);
+                }
+            }
+        }
+        sort(hazards.begin(), hazards.end());
+        auto kept = partition(retired.begin(), retired.end(), [&](const Retired &item) {
+            return binary_search(hazards.begin(), hazards.end(), item.pointer);
+        });
+        for (auto it = kept; it != retired.end(); ++it) {
+            it->destroy(it->pointer);
+        }
+        retired.erase(kept, retired.end());
+    }
+};
+
+//---------------------------------------------------------------------------
+// ConcurrentMap: sharded, lock-striped writes, lock-free reads
+//---------------------------------------------------------------------------
+
+// The keys are spread over a power-of-two number of shards by their hash.
+// Each shard has its own open-addressing table and its own shared_mutex:
+//   - get and contains take no lock at all (hazard pointers keep the table
+//     and the entry they read alive);
+//   - fetch_add on an existing key takes the shard lock in shared mode and
+//     adds atomically, so many threads can count in the same shard at once;
+//   - inserts, removes, update and for_each take the shard lock exclusively.
+class ConcurrentMap {
+public:
+    explicit ConcurrentMap(size_t shardCount = 64) : m_shards(bit_ceil(max<size_t>(shardCount, 1))) {
+        // With one shard the shift would be 64, the full width of size_t,
+        // which is undefined; 63 is harmless because the mask is 0 then
+        m_shardShift = min(64 - countr_zero(m_shards.size()), 63);
+        for (Shard &shard : m_shards) {
+            shard.table.store(new Table(16));
+        }
+    }
+
+    ConcurrentMap(const ConcurrentMap &) = delete;
+    ConcurrentMap &operator=(const ConcurrentMap &) = delete;
+
+    ~ConcurrentMap() {
+        for (Shard &shard : m_shards) {
+            Table *table = shard.table.load();
+            for (size_t i = 0; i <= table->mask; ++i) {
+                Entry *entry = table->slots[i].entry.load();
+                if (entry != nullptr && entry != tombstone()) {
+                    delete entry;
+                }
+            }
+            delete table;
+        }
+    }
+
+    size_t shard_count() const { return m_shards.size(); }
+
+    size_t size() const {
+        size_t total = 0;
+        for (const Shard &shard : m_shards) {
+            total += shard.size.load(memory_order_relaxed);
+        }
+        return total;
+    }
+
+    // Add elements to the map
+    void put(string_view key, int64_t value) {
+        size_t hash = hashKey(key);
+        Shard &shard = shardFor(hash);
+        unique_lock<shared_mutex> lock(shard.lock);
+        if (Entry *entry = findLocked(shard, key, hash)) {
+            entry->value.store(value, memory_order_relaxed);
+        } else {
+            insertLocked(shard, key, hash, value);
+        }
+    }
+
+    // Get the value associated with a key, without taking any lock
+    int64_t get(string_view key) const {
+        int64_t value;
+        if (!tryGet(key, value)) {
+            throw runtime_error("Key not found in the map.");
+        }
+        return value;
+    }
+
+    // Check if a key exists in the map
+    bool contains(string_view key) const {
+        int64_t value;
+        return tryGet(key, value);
+    }
+
+    // Remove an element from the map. The entry is retired, not deleted, in
+    // case a reader is looking at it right now.
+    void remove(string_view key) {
+        size_t hash = hashKey(key);
+        Shard &shard = shardFor(hash);
+        unique_lock<shared_mutex> lock(shard.lock);
+        Table *table = shard.table.load(memory_order_relaxed);
+        for (size_t i = hash & table->mask;; i = (i + 1) & table->mask) {
+            Entry *entry = table->slots[i].entry.load(memory_order_relaxed);
+            if (entry == nullptr) {
+                throw runtime_error("Key not found in the map.");
+            }
+            if (entry != tombstone() && entry->hash == hash && entry->key == key) {
+                table->slots[i].entry.store(tombstone(), memory_order_release);
+                shard.size.fetch_sub(1, memory_order_relaxed);
+                HazardPointers::instance().retire(entry);
+                return;
+            }
+        }
+    }
+
+    // Atomically add delta to the key's value (a missing key starts at 0)
+    // and return the previous value
+    int64_t fetch_add(string_view key, int64_t delta) {
+        size_t hash = hashKey(key);
+        Shard &shard = shardFor(hash);
+        {
+            shared_lock<shared_mutex> lock(shard.lock);
+            if (Entry *entry = findLocked(shard, key, hash)) {
+                return entry->value.fetch_add(delta, memory_order_relaxed);
+            }
+        }
+        unique_lock<shared_mutex> lock(shard.lock);
+        if (Entry *entry = findLocked(shard, key, hash)) {
+            return entry->value.fetch_add(delta, memory_order_relaxed);
+        }
+        insertLocked(shard, key, hash, delta);
+        return 0;
+    }
+
+    // Replace the key's value with fn(old value) as one atomic step (a
+    // missing key starts at 0) and return the new value. fn runs under the
+    // shard lock, so it must not call back into the map.
+    int64_t update(string_view key, const function<int64_t(int64_t)> &fn) {
+        size_t hash = hashKey(key);
+        Shard &shard = shardFor(hash);
+        unique_lock<shared_mutex> lock(shard.lock);
+        Entry *entry = findLocked(shard, key, hash);
+        if (entry == nullptr) {
+            entry = insertLocked(shard, key, hash, 0);
+        }
+        int64_t value = fn(entry->value.load(memory_order_relaxed));
+        entry->value.store(value, memory_order_relaxed);
+        return value;
+    }
+
+    // Iterate over all key-value pairs. Each shard is copied under its lock,
+    // so the pairs of one shard form a consistent snapshot, and the callback
+    // runs after the lock is released: it may read and modify the map,
+    // including the key it was called with.
+    void for_each(function<void(const string &, int64_t)> cb) const {
+        vector<pair<string, int64_t>> snapshot;
+        for (const Shard &shard : m_shards) {
+            snapshot.clear();
+            {
+                unique_lock<shared_mutex> lock(shard.lock);
+                Table *table = shard.table.load(memory_order_relaxed);
+                for (size_t i = 0; i <= table->mask; ++i) {
+                    Entry *entry = table->slots[i].entry.load(memory_order_relaxed);
+                    if (entry != nullptr && entry != tombstone()) {
+                        snapshot.emplace_back(entry->key, entry->value.load(memory_order_relaxed));
+                    }
+                }
+            }
+            for (const auto &[key, value] : snapshot) {
+                cb(key, value);
+            }
+        }
+    }
+
+private:
+    // Keys never change after an entry is published, so readers can compare
+    // them without a lock; only the value is written concurrently.
+    struct Entry {
+        string key;
+        size_t hash = 0;
+        atomic<int64_t> value{0};
+    };
+
+    struct Slot {
+        atomic<Entry *> entry{nullptr};
+    };
+
+    struct Table {
+        size_t mask;
+        unique_ptr<Slot[]> slots;
+
+        explicit Table(size_t capacity) : mask(capacity - 1), slots(make_unique<Slot[]>(capacity)) {}
+    };
+
+    struct alignas(64) Shard {
+        mutable shared_mutex lock;
+        atomic<Table *> table{nullptr};
+        atomic<size_t> size{0};
+        size_t used = 0; // live entries plus tombstones, guarded by lock
+    };
+
+    vector<Shard> m_shards;
+    unsigned m_shardShift;
+
+    static Entry *tombstone() {
+        static Entry marker;
+        return &marker;
+    }
+
+    static size_t hashKey(string_view key) { return hash<string_view>{}(key); }
+
+    // The top bits pick the shard and the low bits the slot, so the two
+    // choices are independent
+    Shard &shardFor(size_t hash) { return m_shards[(hash * 0x9E3779B97F4A7C15ull) >> m_shardShift & (m_shards.size() - 1)]; }
+    const Shard &shardFor(size_t hash) const { return const_cast<ConcurrentMap *>(this)->shardFor(hash); }
+
+    // Lock-free lookup. After an entry is published in a hazard slot, the
+    // reader checks that the shard still uses the same table and the slot
+    // still holds the entry. If so, the entry had not been removed when it
+    // was published, so it cannot be freed while the reader uses it.
+    bool tryGet(string_view key, int64_t &value) const {
+        size_t hash = hashKey(key);
+        const Shard &shard = shardFor(hash);
+        HazardPointers &hazards = HazardPointers::instance();
+        while (true) {
+            Table *table = hazards.protect(0, shard.table);
+            bool restart = false;
+            for (size_t i = hash & table->mask;; i = (i + 1) & table->mask) {
+                Entry *entry = table->slots[i].entry.load(memory_order_acquire);
+                if (entry == nullptr) {
+                    hazards.clear();
+                    return false;
+                }
+                if (entry == tombstone()) {
+                    continue;
+                }
+                hazards.set(1, entry);
+                if (shard.table.load() != table || table->slots[i].entry.load() != entry) {
+                    restart = true;
+                    break;
+                }
+                if (entry->hash == hash && entry->key == key) {
+                    value = entry->value.load(memory_order_relaxed);
+                    hazards.clear();
+                    return true;
+                }
+            }
+            if (!restart) {
+                break;
+            }
+        }
+        hazards.clear();
+        return false;
+    }
+
+    // Lookup for callers holding the shard lock (shared or exclusive): no
+    // entry can be removed and no table replaced while it runs
+    Entry *findLocked(Shard &shard, string_view key, size_t hash) {
+        Table *table = shard.table.load(memory_order_relaxed);
+        for (size_t i = hash & table->mask;; i = (i + 1) & table->mask) {
+            Entry *entry = table->slots[i].entry.load(memory_order_acquire);
+            if (entry == nullptr) {
+                return nullptr;
+            }
+            if (entry != tombstone() && entry->hash == hash && entry->key == key) {
+                return entry;
+            }
+        }
+    }
+
+    // Requires the exclusive lock and a key that is known to be missing.
+    // Linear probing stays short below a load factor of 1/2.
+    Entry *insertLocked(Shard &shard, string_view key, size_t hash, int64_t value) {
+        Table *table = shard.table.load(memory_order_relaxed);
+        if ((shard.used + 1) * 2 > table->mask + 1) {
+            size_t live = shard.size.load(memory_order_relaxed);
+            table = rehash(shard, live * 4 >= table->mask + 1 ? (table->mask + 1) * 2 : table->mask + 1);
+        }
+        Entry *entry = new Entry();
+        entry->key = key;
+        entry->hash = hash;
+        entry->value.store(value, memory_order_relaxed);
+        for (size_t i = hash & table->mask;; i = (i + 1) & table->mask) {
+            Entry *current = table->slots[i].entry.load(memory_order_relaxed);
+            if (current == nullptr || current == tombstone()) {
+                shard.used += current == nullptr;
+                table->slots[i].entry.store(entry, memory_order_release);
+                break;
+            }
+        }
+        shard.size.fetch_add(1, memory_order_relaxed);
+        return entry;
+    }
+
+    // Build a new table without tombstones, publish it, and retire the old
+    // one; readers still probing the old table keep it alive
+    Table *rehash(Shard &shard, size_t capacity) {
+        Table *old = shard.table.load(memory_order_relaxed);
+        Table *table = new Table(capacity);
+        for (size_t i = 0; i <= old->mask; ++i) {
+            Entry *entry = old->slots[i].entry.load(memory_order_relaxed);
+            if (entry == nullptr || entry == tombstone()) {
+                continue;
+            }
+            size_t j = entry->hash & table->mask;
+            while (table->slots[j].entry.load(memory_order_relaxed) != nullptr) {
+                j = (j + 1) & table->mask;
+            }
+            table->slots[j].entry.store(entry, memory_order_relaxed);
+        }
+        shard.used = shard.size.load(memory_order_relaxed);
+        shard.table.store(table, memory_order_release);
+        HazardPointers::instance().retire(old);
+        return table;
+    }
+};
+
+// Example callback function: with per-shard snapshots, changing values
+// from inside for_each is safe
+void modify_values(ConcurrentMap &map) {
+    map.for_each([&](const string &key, int64_t value) {
+        cout << "The key ' " << key << " ' old value is : " << value << ", and it will be modified to: " << value + 1 << endl;
+        map.fetch_add(key, 1);
+    });
+}
+
+//---------------------------------------------------------------------------
+// Baseline: the flat Map from Map.cpp behind one mutex
+//---------------------------------------------------------------------------
+
+// Compact copy of Map's table (control bytes, group probing) with just the
+// operations a counter needs
+class FlatMap {
+public:
+    FlatMap() : m_ctrl(16, kEmpty), m_slots(16) {}
+
+    const int64_t *find(string_view key) const {
+        size_t hash = hashKey(key);
+        size_t index = probe(key, hash);
+        return index == npos ? nullptr : &m_slots[index].second;
+    }
+
+    int64_t &operator[](string_view key) {
+        size_t hash = hashKey(key);
+        size_t index = probe(key, hash);
+        if (index != npos) {
+            return m_slots[index].second;
+        }
+        if ((m_size + 1) * 8 > m_ctrl.size() * 7) {
+            grow();
+        }
+        index = firstEmpty(hash);
+        m_ctrl[index] = h2(hash);
+        m_slots[index] = {string(key), 0};
+        ++m_size;
+        return m_slots[index].second;
+    }
+
+private:
+    static constexpr int8_t kEmpty = -128;
+    static constexpr size_t npos = SIZE_MAX;
+
+    vector<int8_t> m_ctrl;
+    vector<pair<string, int64_t>> m_slots;
+    size_t m_size = 0;
+
+    static size_t hashKey(string_view key) { return hash<string_view>{}(key); }
+    static int8_t h2(size_t hash) { return static_cast<int8_t>(hash & 0x7F); }
+
+    size_t probe(string_view key, size_t hash) const {
+        size_t groups = m_ctrl.size() / 16;
+        size_t group = (hash >> 7) & (groups - 1);
+        for (size_t step = 1;; ++step) {
+            bool sawEmpty = false;
+            for (size_t i = group * 16; i < group * 16 + 16; ++i) {
+                if (m_ctrl[i] == h2(hash) && m_slots[i].first == key) {
+                    return i;
+                }
+                sawEmpty |= m_ctrl[i] == kEmpty;
+            }
+            if (sawEmpty) {
+                return npos;
+            }
+            group = (group + step) & (groups - 1);
+        }
+    }
+
+    size_t firstEmpty(size_t hash) const {
+        size_t groups = m_ctrl.size() / 16;
+        size_t group = (hash >> 7) & (groups - 1);
+        for (size_t step = 1;; ++step) {
+            for (size_t i = group * 16; i < group * 16 + 16; ++i) {
+                if (m_ctrl[i] == kEmpty) {
+                    return i;
+                }
+            }
+            group = (group + step) & (groups - 1);
+        }
+    }
+
+    void grow() {
+        vector<int8_t> oldCtrl(m_ctrl.size() * 2, kEmpty);
+        vector<pair<string, int64_t>> oldSlots(m_slots.size() * 2);
+        oldCtrl.swap(m_ctrl);
+        oldSlots.swap(m_slots);
+        for (size_t i = 0; i < oldCtrl.size(); ++i) {
+            if (oldCtrl[i] != kEmpty) {
+                size_t hash = hashKey(oldSlots[i].first);
+                size_t index = firstEmpty(hash);
+                m_ctrl[index] = h2(hash);
+                m_slots[index] = std::move(oldSlots[i]);
+            }
+        }
+    }
+};
+
+class LockedMap {
+public:
+    int64_t fetch_add(string_view key, int64_t delta) {
+        lock_guard<mutex> lock(m_mutex);
+        int64_t &value = m_map[key];
+        int64_t old = value;
+        value += delta;
+        return old;
+    }
+
+    bool contains(string_view key) const {
+        lock_guard<mutex> lock(m_mutex);
+        return m_map.find(key) != nullptr;
+    }
+
+private:
+    mutable mutex m_mutex;
+    FlatMap m_map;
+};
+
+//---------------------------------------------------------------------------
+// Benchmark: counters under a zipfian key distribution
+//---------------------------------------------------------------------------
+
+// Draws key indices where key i has probability proportional to 1 / (i+1)^s
+class Zipf {
+public:
+    Zipf(size_t n, double s) : m_cdf(n) {
+        double total = 0;
+        for (size_t i = 0; i < n; ++i) {
+            total += 1.0 / pow(static_cast<double>(i + 1), s);
+            m_cdf[i] = total;
+        }
+        for (double &value : m_cdf) {
+            value /= total;
+        }
+    }
+
+    template <typename Rng>
+    size_t operator()(Rng &rng) const {
+        double u = uniform_real_distribution<double>(0.0, 1.0)(rng);
+        return min<size_t>(lower_bound(m_cdf.begin(), m_cdf.end(), u) - m_cdf.begin(), m_cdf.size() - 1);
+    }
+
+private:
+    vector<double> m_cdf;
+};
+
+// Every thread runs its own precomputed list of keys; even positions
+// increment a counter, odd positions read one
+template <typename MapType>
+double measureThroughput(MapType &map, const vector<string> &keys, const vector<vector<uint32_t>> &work, size_t threads) {
+    atomic<bool> start{false};
+    atomic<size_t> found{0};
+    vector<thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            const vector<uint32_t> &mine = work[t];
+            size_t hits = 0;
+            while (!start.load(memory_order_acquire)) {
+                this_thread::yield();
+            }
+            for (size_t i = 0; i + 1 < mine.size(); i += 2) {
+                map.fetch_add(keys[mine[i]], 1);
+                hits += map.contains(keys[mine[i + 1]]);
+            }
+            found.fetch_add(hits);
+        });
+    }
+    auto begin = chrono::steady_clock::now();
+    start.store(true, memory_order_release);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - begin;
+    return static_cast<double>(threads * work[0].size()) / elapsed.count();
+}
+
+// Threads count, remove and re-insert keys while others read them; at the
+// end every increment must be accounted for
+bool checkConcurrentCounts() {
+    ConcurrentMap map(8);
+    const int threads = 8;
+    const int perThread = 100000;
+    const int keyCount = 1000;
+    vector<string> keys;
+    for (int i = 0; i < keyCount; ++i) {
+        keys.push_back("counter:" + to_string(i));
+    }
+
+    atomic<bool> stop{false};
+    thread churn([&] {
+        // Keys outside the counted range are added and removed constantly,
+        // which forces rehashes and tombstones in every shard
+        for (int round = 0; !stop.load(); ++round) {
+            string key = "temporary:" + to_string(round % 5000);
+            map.put(key, round);
+            map.remove(key);
+        }
+    });
+
+    vector<thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            mt19937 rng(t);
+            for (int i = 0; i < perThread; ++i) {
+                map.fetch_add(keys[rng() % keyCount], 1);
+                map.contains(keys[rng() % keyCount]);
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    stop.store(true);
+    churn.join();
+
+    int64_t total = 0;
+    map.for_each([&](const string &, int64_t value) { total += value; });
+    bool ok = total == static_cast<int64_t>(threads) * perThread && map.size() == static_cast<size_t>(keyCount);
+    cout << (ok ? "All " : "[MISMATCH] ") << total << " concurrent increments counted, " << map.size() << " keys" << endl;
+    return ok;
+}
+
+int main(int argc, char *argv[]) {
+    ConcurrentMap map;
+
+    map.put("one", 1);
+    map.put("two", 2);
+    map.put("three", 3);
+
+    if (map.contains("one")) {
+        cout << "One exists in the map." << endl;
+    }
+
+    try {
+        int64_t value = map.get("four");
+        cout << "The value for 'four' is: " << value << endl; // This line should throw an exception
+    } catch (const runtime_error &e) {
+        cerr << e.what() << endl;
+    }
+
+    map.remove("two");
+    map.update("three", [](int64_t value) { return value * 10; });
+
+    modify_values(map);
+
+    cout << "Size of the map: " << map.size() << endl;
+    cout << "one = " << map.get("one") << ", three = " << map.get("three") << endl;
+
+    cout << endl;
+    checkConcurrentCounts();
+
+    size_t opsPerThread = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    const size_t keyCount = 1000000;
+    vector<string> keys;
+    for (size_t i = 0; i < keyCount; ++i) {
+        keys.push_back("user:" + to_string(i));
+    }
+    Zipf zipf(keyCount, 0.99);
+    const vector<size_t> threadCounts = {1, 2, 4, 8, 16, 32, 48, 64};
+    vector<vector<uint32_t>> work(threadCounts.back());
+    for (size_t t = 0; t < work.size(); ++t) {
+        mt19937_64 rng(t + 1);
+        work[t].resize(opsPerThread);
+        for (uint32_t &key : work[t]) {
+            key = static_cast<uint32_t>(zipf(rng));
+        }
+    }
+
+    cout << "\nThroughput (zipf 0.99 over " << keyCount << " keys, 50% fetch_add / 50% contains, Mops/s):" << endl;
+    cout << "threads  mutex+Map  sharded-64  sharded-256" << endl;
+    for (size_t threads : threadCounts) {
+        LockedMap locked;
+        ConcurrentMap sharded64(64);
+        ConcurrentMap sharded256(256);
+        cout << threads
+             << "\t " << measureThroughput(locked, keys, work, threads) / 1e6
+             << "\t    " << measureThroughput(sharded64, keys, work, threads) / 1e6
+             << "\t" << measureThroughput(sharded256, keys, work, threads) / 1e6
+             << endl;
+    }
+
+    return 0;
+}
+```
+
+This C++ code implements `ConcurrentMap`, a thread-safe variant of the `Map` in `Map.cpp` for counters that many threads update at once. The keys are split over a number of shards, and each shard has its own table and its own lock (lock striping). Lookups take no lock at all, `fetch_add` and `update` change a value atomically, and `for_each` sees a consistent snapshot of each shard, so the callback can safely modify the map it is iterating over.
+
+The code is divided into four main parts:
+
+1. `HazardPointers`: A compact copy of the memory reclamation scheme from `LockFreeLinkedList.cpp`. It lets a writer remove an entry or replace a table while readers may still be using it.
+
+2. `ConcurrentMap`: The sharded map.
+
+3. The baseline: A compact copy of the flat table from `Map.cpp` behind a single mutex (`FlatMap` and `LockedMap`).
+
+4. The main function: A small demo, a correctness check where eight threads count while another thread keeps inserting and removing keys, and a throughput table for 1 to 64 threads. The keys follow a zipfian distribution, so a few keys are very hot and most are rarely touched, as with real counters. The number of operations per thread can be passed as the first command line argument.
+
+This C++ code matters for several reasons:
+
+1. **Lock contention**: With one mutex around the whole map, every thread waits for every other thread, and adding threads makes things slower. With 64 shards, two threads only wait for each other when their keys land in the same shard.
+
+2. **Readers never block**: Reads are usually the most common operation. `get` and `contains` do not take the shard lock, so they never wait for a writer, and they never make a writer wait.
+
+3. **Atomic updates**: A counter update written as `put(key, get(key) + 1)` loses increments when two threads run it at the same time. `fetch_add` and `update` do the read and the write as one step.
+
+4. **Safe iteration**: The original `modify_values` calls `put` from inside `for_each`, which changes the map while it is being iterated. Here `for_each` copies each shard under its lock and calls the callback on the copy, so the callback can do anything with the map.
+
+Here's a breakdown of the concepts used in the code:
+
+1. Shards: `shardFor(hash)` multiplies the hash by a large odd constant and takes the top bits to choose a shard. The low bits of the same hash choose the slot inside the shard's table, so the two choices do not depend on each other. The shard count is rounded up to a power of two.
+
+2. `Shard`: Each shard is `alignas(64)`, so the locks of neighbouring shards do not share a cache line. It holds a `shared_mutex`, an atomic pointer to its `Table`, and its size.
+
+3. `Table` and `Entry`: A table is an array of atomic pointers to entries, probed linearly and kept at most half full. An entry holds the key, its hash and an `atomic<int64_t>` value. The key never changes after the entry is published, which is what makes lock-free reads possible.
+
+4. `tryGet`: Publishes the table pointer in hazard slot 0 and each candidate entry in slot 1, then checks that the shard still uses the same table and the slot still holds the same entry. If both are true, the entry was still in the map when the reader published it, so the writer that removes it later will see the hazard pointer and will not free it.
+
+5. `remove`: Replaces the entry with a tombstone and retires the entry. Tombstones keep the probe sequences of other keys intact, and they disappear the next time the shard's table is rebuilt.
+
+6. `insertLocked` and `rehash`: When live entries plus tombstones would exceed half the table, the shard builds a new table, either twice the size or the same size if most of the used slots are tombstones, and publishes it with one atomic store. The entries themselves are not copied, only their pointers, so a value that another thread is adding to stays in one place. The old table is retired.
+
+7. `fetch_add(key, delta)`: If the key exists, it takes the shard lock in shared mode and adds with an atomic `fetch_add`, so many threads can count in the same shard at the same time. Only if the key is missing does it take the lock exclusively to insert it.
+
+8. `update(key, fn)`: Takes the shard lock exclusively and replaces the value with `fn(old)`. Since `fetch_add` holds the shared lock while it adds, no increment can slip in between the read and the write.
+
+9. `for_each(cb)`: For each shard, takes the exclusive lock, copies the keys and values, releases the lock, and then calls `cb` on the copy. The pairs from one shard form a snapshot; pairs from different shards may be from slightly different moments.
+
+10. `Zipf`: Draws key indices with probability proportional to `1 / (i + 1)^s` by binary searching a precomputed cumulative distribution. The keys for every thread are drawn before the timing starts.
+
+Here are some common beginner mistakes to avoid with concurrent maps:
+
+1. **Reading without a lock and without reclamation**: A reader that follows a pointer into the map while another thread deletes that entry reads freed memory. The entry must stay alive until no reader can still be using it, which is what the hazard pointers guarantee.
+
+2. **Checking the slot but not the table**: If the table was replaced, the old table is frozen and its slots no longer change when entries are removed. A reader must check that it is still looking at the current table, or it may use an entry that has already been freed.
+
+3. **Calling the map from inside a locked callback**: If `for_each` called the callback while holding the shard lock, a callback that updates the same shard would deadlock. Copy first, then call. For the same reason, the function passed to `update` must not call back into the map.
+
+4. **Putting the locks side by side**: An array of plain mutexes puts several of them on one cache line, and threads working on different shards still slow each other down. Align each shard to a cache line.
+
+5. **Expecting hot keys to scale**: Sharding spreads different keys over different locks, but all updates of the single hottest key still go to one cache line. Under a zipfian distribution, a few keys get a large share of the updates, so check scaling with realistic key distributions, not just uniform ones.
+
+6. **Benchmarking on too few cores**: On a machine with one or two cores the threads rarely run at the same time, and a single mutex can look just as fast. Run the table on hardware with as many cores as production.
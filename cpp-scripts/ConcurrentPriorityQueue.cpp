@@ -0,0 +1,452 @@
+```cpp
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+#include <cstdint>
+#include <cstdlib>
+
+//---------------------------------------------------------------------------
+// Sequential building block: a compact d-ary MinHeap (see Heap.cpp)
+//---------------------------------------------------------------------------
+
+template <typename T, typename Compare = std::less<T>, std::size_t Arity = 4>
+class MinHeap {
+public:
+    bool empty() const { return heap.empty(); }
+    std::size_t size() const { return heap.size(); }
+
+    const T& top() const {
+        if (heap.empty()) {
+            throw std::out_of_range("Heap is empty");
+        }
+        return heap[0];
+    }
+
+    void insert(T element) {
+        heap.push_back(std::move(element));
+        std::size_t index = heap.size() - 1;
+        T hole = std::move(heap[index]);
+        while (index > 0 && less(hole, heap[(index - 1) / Arity])) {
+            heap[index] = std::move(heap[(index - 1) / Arity]);
+            index = (index - 1) / Arity;
+        }
+        heap[index] = std::move(hole);
+    }
+
+    T deleteMin() {
+        if (heap.empty()) {
+            throw std::out_of_range("Heap is empty");
+        }
+        T minValue = std::move(heap[0]);
+        T hole = std::move(heap.back());
+        heap.pop_back();
+        const std::size_t count = heap.size();
+        if (count == 0) {
+            return minValue;
+        }
+        std::size_t index = 0;
+        while (true) {
+            std::size_t child = Arity * index + 1;
+            if (child >= count) {
+                break;
+            }
+            std::size_t minIndex = child;
+            for (std::size_t i = child + 1; i < std::min(child + Arity, count); ++i) {
+                if (less(heap[i], heap[minIndex])) {
+                    minIndex = i;
+                }
+            }
+            if (!less(heap[minIndex], hole)) {
+                break;
+            }
+            heap[index] = std::move(heap[minIndex]);
+            index = minIndex;
+        }
+        heap[index] = std::move(hole);
+        return minValue;
+    }
+
+private:
+    std::vector<T> heap;
+    Compare less;
+};
+
+//---------------------------------------------------------------------------
+// Baseline: one mutex around one MinHeap
+//---------------------------------------------------------------------------
+
+template <typename T>
+struct Item {
+    std::uint64_t priority;
+    T value;
+
+    bool operator<(const Item& other) const { return priority < other.priority; }
+};
+
+template <typename T>
+class LockedMinHeap {
+public:
+    void push(std::uint64_t priority, T value) {
+        std::lock_guard<std::mutex> lock(mtx);
+        heap.insert(Item<T>{priority, std::move(value)});
+    }
+
+    bool tryDeleteMin(Item<T>& out) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (heap.empty()) {
+            return false;
+        }
+        out = heap.deleteMin();
+        return true;
+    }
+
+private:
+    std::mutex mtx;
+    MinHeap<Item<T>> heap;
+};
+
+//---------------------------------------------------------------------------
+// MultiQueue: c * p independently locked heaps with two-choice deletion
+//---------------------------------------------------------------------------
+
+enum class Ordering {
+    Strict,  // one shard: exact priority order, same contention as LockedMinHeap
+    Relaxed  // c * p shards: expected rank error O(c * p), scales with threads
+};
+
+template <typename T>
+class MultiQueue {
+public:
+    MultiQueue(std::size_t threads, std::size_t queuesPerThread, Ordering ordering = Ordering::Relaxed)
+        : shardCount(ordering == Ordering::Strict ? 1 : std::max<std::size_t>(2, threads * queuesPerThread)),
+          shards(new Shard[shardCount]) {}
+
+    std::size_t shardsInUse() const { return shardCount; }
+
+    // Function to insert an element into a random unlocked shard. After
+    // maxTryLocks shards in a row were locked, it waits for the next one
+    // instead of spinning, which matters most with a single shard.
+    void push(std::uint64_t priority, T value) {
+        for (int attempt = 0;; ++attempt) {
+            Shard& shard = shards[randomShard()];
+            std::unique_lock<std::mutex> lock(shard.mtx, std::defer_lock);
+            if (attempt < maxTryLocks) {
+                if (!lock.try_lock()) {
+                    continue;
+                }
+            } else {
+                lock.lock();
+            }
+            shard.heap.insert(Item<T>{priority, std::move(value)});
+            shard.publishTop();
+            return;
+        }
+    }
+
+    // Function to remove an element close to the global minimum. Two random
+    // shards are compared through their cached tops and the better one is
+    // popped, which keeps the expected rank error proportional to the shard
+    // count. Returns false only after a full scan found every shard empty.
+    bool tryDeleteMin(Item<T>& out) {
+        for (int attempt = 0; attempt < 2 * static_cast<int>(shardCount) + 8; ++attempt) {
+            std::size_t first = randomShard();
+            std::size_t second = randomShard();
+            std::uint64_t firstTop = shards[first].top.load(std::memory_order_relaxed);
+            std::uint64_t secondTop = shards[second].top.load(std::memory_order_relaxed);
+            std::size_t chosen = secondTop < firstTop ? second : first;
+            if (std::min(firstTop, secondTop) == emptyTop) {
+                continue;
+            }
+            if (popFrom(shards[chosen], out, attempt >= maxTryLocks)) {
+                return true;
+            }
+        }
+        // Fall back to a linear scan so an almost empty queue is still drained
+        for (std::size_t i = 0; i < shardCount; ++i) {
+            if (shards[i].top.load(std::memory_order_relaxed) == emptyTop) {
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(shards[i].mtx);
+            if (!shards[i].heap.empty()) {
+                out = shards[i].heap.deleteMin();
+                shards[i].publishTop();
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    static constexpr std::uint64_t emptyTop = std::numeric_limits<std::uint64_t>::max();
+    static constexpr int maxTryLocks = 4;
+
+    // Each shard sits on its own cache line so threads working on
+    // neighbouring shards do not invalidate each other's lock word.
+    struct alignas(64) Shard {
+        std::mutex mtx;
+        std::atomic<std::uint64_t> top{emptyTop};
+        MinHeap<Item<T>> heap;
+
+        void publishTop() {
+            top.store(heap.empty() ? emptyTop : heap.top().priority, std::memory_order_relaxed);
+        }
+    };
+
+    std::size_t shardCount;
+    std::unique_ptr<Shard[]> shards;
+
+    // Pops from shard unless it is empty, or locked and block is false
+    bool popFrom(Shard& shard, Item<T>& out, bool block) {
+        std::unique_lock<std::mutex> lock(shard.mtx, std::defer_lock);
+        if (block) {
+            lock.lock();
+        } else if (!lock.try_lock()) {
+            return false;
+        }
+        if (shard.heap.empty()) {
+            return false;
+        }
+        out = shard.heap.deleteMin();
+        shard.publishTop();
+        return true;
+    }
+
+    // Per-thread xorshift generator: cheap and free of shared state
+    std::size_t randomShard() const {
+        thread_local std::uint64_t state =
+            std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return static_cast<std::size_t>(state % shardCount);
+    }
+};
+
+//---------------------------------------------------------------------------
+// Rank error: how far from the true minimum does a relaxed pop land?
+//---------------------------------------------------------------------------
+
+// Fenwick tree over priorities 0..n-1 counting the elements still queued
+class FenwickTree {
+public:
+    explicit FenwickTree(std::size_t n) : tree(n + 1, 0) {}
+
+    void add(std::size_t index, int delta) {
+        for (++index; index < tree.size(); index += index & (~index + 1)) {
+            tree[index] += delta;
+        }
+    }
+
+    // Number of queued priorities strictly below index
+    long long countBelow(std::size_t index) const {
+        long long sum = 0;
+        for (; index > 0; index -= index & (~index + 1)) {
+            sum += tree[index];
+        }
+        return sum;
+    }
+
+private:
+    std::vector<long long> tree;
+};
+
+void measureRankError(std::size_t threads, std::size_t queuesPerThread, std::size_t n) {
+    MultiQueue<std::uint32_t> queue(threads, queuesPerThread);
+    std::vector<std::uint32_t> priorities(n);
+    std::iota(priorities.begin(), priorities.end(), 0);
+    std::shuffle(priorities.begin(), priorities.end(), std::mt19937(7));
+
+    FenwickTree queued(n);
+    for (std::uint32_t priority : priorities) {
+        queue.push(priority, priority);
+        queued.add(priority, 1);
+    }
+
+    Item<std::uint32_t> item{};
+    double totalRank = 0;
+    long long maxRank = 0;
+    while (queue.tryDeleteMin(item)) {
+        long long rank = queued.countBelow(item.priority);
+        queued.add(item.priority, -1);
+        totalRank += static_cast<double>(rank);
+        maxRank = std::max(maxRank, rank);
+    }
+    std::cout << "  " << queue.shardsInUse() << " shards: mean rank error "
+              << totalRank / static_cast<double>(n) << ", max " << maxRank << std::endl;
+}
+
+//---------------------------------------------------------------------------
+// Throughput: every thread alternates push and deleteMin on a prefilled queue
+//---------------------------------------------------------------------------
+
+template <typename Queue>
+double measureThroughput(Queue& queue, std::size_t threads, std::size_t opsPerThread, std::size_t prefill) {
+    std::mt19937_64 rng(1);
+    for (std::size_t i = 0; i < prefill; ++i) {
+        queue.push(rng() % (1u << 30), 0);
+    }
+
+    std::atomic<bool> start{false};
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::mt19937_64 local(t + 100);
+            Item<int> item{};
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for (std::size_t i = 0; i < opsPerThread; i += 2) {
+                queue.push(local() % (1u << 30), static_cast<int>(t));
+                queue.tryDeleteMin(item);
+            }
+        });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    return static_cast<double>(threads * opsPerThread) / elapsed.count();
+}
+
+int main(int argc, char* argv[]) {
+    // Small demo: 4 producers insert deadlines, 2 workers drain them
+    MultiQueue<int> jobs(6, 2);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < 4; ++p) {
+        producers.emplace_back([&jobs, p] {
+            for (int i = 0; i < 1000; ++i) {
+                jobs.push(static_cast<std::uint64_t>(i * 4 + p), p);
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    std::atomic<int> drained{0};
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < 2; ++c) {
+        consumers.emplace_back([&jobs, &drained] {
+            Item<int> job{};
+            while (jobs.tryDeleteMin(job)) {
+                drained.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+    std::cout << "Drained " << drained.load() << " of 4000 jobs" << std::endl;
+
+    // The same producers against a strict queue: every push contends for
+    // the one shard, and a single worker must see the deadlines in order
+    MultiQueue<int> strict(6, 2, Ordering::Strict);
+    producers.clear();
+    for (int p = 0; p < 4; ++p) {
+        producers.emplace_back([&strict, p] {
+            for (int i = 0; i < 1000; ++i) {
+                strict.push(static_cast<std::uint64_t>(i * 4 + p), p);
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    Item<int> job{};
+    std::uint64_t previous = 0;
+    int inOrder = 0;
+    while (strict.tryDeleteMin(job)) {
+        inOrder += job.priority >= previous ? 1 : 0;
+        previous = job.priority;
+    }
+    std::cout << "Strict: " << inOrder << " of 4000 jobs in deadline order" << std::endl;
+
+    std::cout << "\nRank error of sequential pops (p = 16):" << std::endl;
+    for (std::size_t c : {1, 2, 4}) {
+        measureRankError(16, c, 1000000);
+    }
+
+    std::size_t opsPerThread = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    std::cout << "\nThroughput (50% push / 50% deleteMin, Mops/s):" << std::endl;
+    std::cout << "threads  locked-heap  multiqueue-c2  multiqueue-c4  multiqueue-strict" << std::endl;
+    for (std::size_t threads : {1, 2, 4, 8, 16, 32, 64}) {
+        LockedMinHeap<int> locked;
+        MultiQueue<int> relaxed2(threads, 2);
+        MultiQueue<int> relaxed4(threads, 4);
+        MultiQueue<int> strict(threads, 1, Ordering::Strict);
+        std::cout << threads
+                  << "\t " << measureThroughput(locked, threads, opsPerThread, 1000000) / 1e6
+                  << "\t      " << measureThroughput(relaxed2, threads, opsPerThread, 1000000) / 1e6
+                  << "\t     " << measureThroughput(relaxed4, threads, opsPerThread, 1000000) / 1e6
+                  << "\t    " << measureThroughput(strict, threads, opsPerThread, 1000000) / 1e6
+                  << std::endl;
+    }
+
+    return 0;
+}
+```
+
+This C++ code implements a concurrent priority queue called a MultiQueue. It is built for the situation where many producer threads insert deadlines and many worker threads call `deleteMin` at the same time, and a single mutex around one heap has become the bottleneck.
+
+The code is divided into four main parts:
+
+1. `MinHeap`: A compact copy of the d-ary heap from `Heap.cpp`, reduced to `insert`, `top` and `deleteMin`. It is the sequential building block every shard uses.
+
+2. `LockedMinHeap`: The baseline, one `std::mutex` around one `MinHeap`. Every thread has to take the same lock for every operation.
+
+3. `MultiQueue`: `c * p` shards, where `p` is the number of threads and `c` is the number of queues per thread. Each shard is a `MinHeap` with its own lock. Insertions go to a random shard; deletions look at two random shards and pop from the one with the smaller top.
+
+4. The main function: A small demo with four producers and two workers, the same producers against a strict queue drained in order by one worker, a measurement of the rank error, and a throughput table for 1 to 64 threads that includes the strict mode. The number of operations per thread can be passed as the first command line argument.
+
+This code matters for several reasons:
+
+1. **Scalability**: With `c * p` shards and `try_lock`, two threads only collide when they pick the same shard at the same moment. A thread that finds a shard busy simply picks another one instead of waiting.
+
+2. **Relaxed ordering**: A MultiQueue does not always return the exact minimum. It returns an element whose rank (the number of smaller elements still queued) is small on average. The two-choice rule keeps the expected rank error proportional to the number of shards, so `Ordering::Strict` (a single shard) gives exact ordering and `Ordering::Relaxed` trades a bounded amount of ordering for throughput. For deadline scheduling, running a job a few positions early is usually harmless.
+
+3. **Measuring, not guessing**: The rank error is measured with a Fenwick tree over the priorities, and throughput is reported in millions of operations per second for every thread count, so the trade-off can be checked on the target machine.
+
+Here's a breakdown of the concepts used in the code:
+
+1. `struct Item`: Pairs a 64-bit priority with a payload. Using an integer priority lets each shard publish its current minimum through a `std::atomic<std::uint64_t>`, which other threads can read without taking the lock.
+
+2. `alignas(64) struct Shard`: Each shard holds a mutex, the atomic cached top and a heap. Aligning the shard to a cache line prevents false sharing, where two threads working on different shards still slow each other down because their data shares a cache line.
+
+3. `publishTop()`: Called while the shard is locked, after every change, so the cached top is always the heap's real minimum at the moment the lock is released. Readers may see a slightly stale value, which only affects which shard they pick, never correctness.
+
+4. `std::unique_lock` with `try_lock`: Attempts to lock without blocking. If the lock is taken, the operation retries on another random shard. After `maxTryLocks` failed attempts it blocks on `lock()` instead, so with a single shard (`Ordering::Strict`) a contended thread sleeps in the mutex rather than spinning on it.
+
+5. `randomShard()`: A `thread_local` xorshift generator. Using a shared `std::mt19937` would itself become a contended object.
+
+6. `tryDeleteMin(out)`: Makes a bounded number of two-choice attempts and then falls back to scanning every shard. It returns `false` only when every shard was found empty, so workers can use it as a loop condition.
+
+7. `FenwickTree`: A binary indexed tree that counts how many priorities below a given value are still queued, in O(log n). It turns "what was the rank of this pop?" into a cheap query.
+
+8. `measureThroughput`: Starts all threads behind an atomic start flag so they begin at the same time, then lets each one alternate a push and a pop on a prefilled queue.
+
+Here are some common beginner mistakes to avoid with concurrent data structures like this one:
+
+1. **Reading shared data without synchronization**: The cached top is a `std::atomic` for a reason. Reading `heap.top()` of another shard without holding its lock is a data race and undefined behavior, even if it "usually works".
+
+2. **Blocking on a busy lock**: Using `lock()` instead of `try_lock()` inside the two-choice loop makes threads queue up behind each other again, which brings back the contention the MultiQueue was meant to remove.
+
+3. **Sharing one random generator**: A single global random number generator is written on every call and becomes the new hottest cache line.
+
+4. **False sharing**: Putting shards in a plain array without `alignas(64)` lets unrelated locks share a cache line, which can cost more than the lock itself.
+
+5. **Giving up too early on empty shards**: Two random shards can both be empty while others still hold elements. Without the final scan, workers could stop while work remains.
+
+6. **Expecting exact ordering**: Code that depends on strictly increasing priorities must use `Ordering::Strict` or the locked heap. The relaxed mode only promises that popped elements are close to the minimum.
@@ -1,112 +1,463 @@
 ```cpp
 #include <iostream>
 #include <vector>
-
+#include <queue>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <bit>
+#include <iterator>
+#include <type_traits>
+#include <cstdlib>
+
+// Indexed d-ary min-heap. Every inserted element gets a handle that stays
+// valid until the element leaves the heap, so its key can be lowered or the
+// element removed in O(log n) without searching for it.
+template <typename T, typename Compare = std::less<T>, std::size_t Arity = 2>
 class MinHeap {
-private:
-    std::vector<int> heap;
+    static_assert(Arity >= 2, "A heap node needs at least two children");
+
+public:
+    using Handle = std::uint32_t;
 
-    // Helper function to find the parent node of an index
-    int parent(int index) {
-        if (index <= 0 || index > heap.size()) {
-            std::cerr << "Invalid Index" << std::endl;
-            exit(EXIT_FAILURE);
+    explicit MinHeap(Compare compare = Compare()) : less(compare) {}
+
+    // Constructor to build a heap from existing data in O(n). The element at
+    // index i of the input receives handle i.
+    explicit MinHeap(std::vector<T> elements, Compare compare = Compare()) : less(compare) {
+        if (elements.size() > std::numeric_limits<Handle>::max()) {
+            throw std::length_error("Too many heap handles");
+        }
+        heap.reserve(elements.size());
+        position.reserve(elements.size());
+        for (T& element : elements) {
+            Handle handle = static_cast<Handle>(position.size());
+            position.push_back(heap.size());
+            heap.push_back(Entry{std::move(element), handle});
         }
-        return (index - 1) / 2;
+        buildHeap();
     }
 
-    // Helper function to find the left child node of an index
-    int leftChild(int index) {
-        if (index <= 0 || index > heap.size()) {
-            std::cerr << "Invalid Index" << std::endl;
-            exit(EXIT_FAILURE);
-        }
-        return 2 * index + 1;
+    bool empty() const { return heap.empty(); }
+    std::size_t size() const { return heap.size(); }
+
+    // Function to reserve room for a known number of elements up front
+    void reserve(std::size_t capacity) {
+        heap.reserve(capacity);
+        position.reserve(capacity);
     }
 
-    // Helper function to find the right child node of an index
-    int rightChild(int index) {
-        if (index <= 0 || index > heap.size()) {
-            std::cerr << "Invalid Index" << std::endl;
-            exit(EXIT_FAILURE);
-        }
-        return 2 * index + 2;
+    // Function to check whether a handle still refers to an element in the heap
+    bool contains(Handle handle) const {
+        return handle < position.size() && position[handle] != npos;
     }
 
-public:
-    // Function to construct a heap
-    void buildHeap() {
-        for (int i = ((heap.size() - 2) / 2); i >= 0; --i) {
-            heapify(i);
+    // Function to return the minimum element without removing it
+    const T& top() const {
+        if (heap.empty()) {
+            throw std::out_of_range("Heap is empty");
         }
+        return heap[0].value;
+    }
+
+    // Function to return the element a handle refers to
+    const T& value(Handle handle) const {
+        return heap[checkedPosition(handle)].value;
     }
 
     // Function to insert an element into the heap
-    void insert(int element) {
-        heap.push_back(element);
-        int index = heap.size() - 1;
-        while (index > 0 && heap[parent(index)] > heap[index]) {
-            std::swap(heap[index], heap[parent(index)]);
-            index = parent(index);
-        }
+    Handle insert(T element) {
+        Handle handle = allocateHandle();
+        heap.push_back(Entry{std::move(element), handle});
+        position[handle] = heap.size() - 1;
+        siftUp(heap.size() - 1);
+        return handle;
+    }
+
+    // Function to insert a batch of elements. Small batches are sifted up one
+    // by one; once the batch is large compared to the heap, appending
+    // everything and rebuilding bottom-up in O(n) is cheaper than O(k log n).
+    template <typename InputIt>
+    void insertBulk(InputIt first, InputIt last) {
+        appendBulk(first, last, nullptr);
+    }
+
+    // Same as above, additionally appending the new handles in input order
+    template <typename InputIt>
+    void insertBulk(InputIt first, InputIt last, std::vector<Handle>& handles) {
+        appendBulk(first, last, &handles);
     }
 
     // Function to delete and return the minimum element from the heap
-    int deleteMin() {
-        if (heap.size() == 0) {
-            std::cerr << "Heap is empty" << std::endl;
-            exit(EXIT_FAILURE);
+    T deleteMin() {
+        if (heap.empty()) {
+            throw std::out_of_range("Heap is empty");
         }
-        int minValue = heap[0];
-        std::swap(heap[0], heap[heap.size() - 1]);
-        heap.pop_back();
-        heapify(0);
+        T minValue = std::move(heap[0].value);
+        removeAt(0);
         return minValue;
     }
 
-    // Helper function to maintain the heap property, starting from a given index
-    void heapify(int index) {
-        int minIndex = index;
-        int leftIndex = leftChild(index);
-        int rightIndex = rightChild(index);
+    // Function to replace an element's key with a smaller (or equal) one
+    void decreaseKey(Handle handle, T element) {
+        std::size_t index = checkedPosition(handle);
+        if (less(heap[index].value, element)) {
+            throw std::invalid_argument("decreaseKey cannot increase a key");
+        }
+        heap[index].value = std::move(element);
+        siftUp(index);
+    }
+
+    // Function to remove an arbitrary element by its handle
+    void erase(Handle handle) {
+        removeAt(checkedPosition(handle));
+    }
+
+    // Function to print the heap in array order
+    void printHeap() const {
+        for (const Entry& entry : heap) {
+            std::cout << entry.value << " ";
+        }
+        std::cout << std::endl;
+    }
+
+private:
+    struct Entry {
+        T value;
+        Handle handle;
+    };
+
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    std::vector<Entry> heap;
+    std::vector<std::size_t> position; // handle -> index in heap, npos when unused
+    std::vector<Handle> freeHandles;
+    Compare less;
+
+    // Helper functions to navigate the implicit d-ary tree. They are only
+    // called with indices the sift loops have already range-checked.
+    static std::size_t parent(std::size_t index) { return (index - 1) / Arity; }
+    static std::size_t firstChild(std::size_t index) { return Arity * index + 1; }
+
+    std::size_t checkedPosition(Handle handle) const {
+        if (!contains(handle)) {
+            throw std::out_of_range("Invalid heap handle");
+        }
+        return position[handle];
+    }
 
-        if (leftIndex < heap.size() && heap[leftIndex] < heap[minIndex]) {
-            minIndex = leftIndex;
+    Handle allocateHandle() {
+        if (!freeHandles.empty()) {
+            Handle handle = freeHandles.back();
+            freeHandles.pop_back();
+            return handle;
+        }
+        if (position.size() > std::numeric_limits<Handle>::max()) {
+            throw std::length_error("Too many heap handles");
         }
+        position.push_back(npos);
+        return static_cast<Handle>(position.size() - 1);
+    }
 
-        if (rightIndex < heap.size() && heap[rightIndex] < heap[minIndex]) {
-            minIndex = rightIndex;
+    template <typename InputIt>
+    void appendBulk(InputIt first, InputIt last, std::vector<Handle>* handles) {
+        const std::size_t oldSize = heap.size();
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+                                        typename std::iterator_traits<InputIt>::iterator_category>) {
+            reserve(oldSize + static_cast<std::size_t>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            Handle handle = allocateHandle();
+            position[handle] = heap.size();
+            heap.push_back(Entry{*first, handle});
+            if (handles != nullptr) {
+                handles->push_back(handle);
+            }
         }
 
-        if (index != minIndex) {
-            std::swap(heap[index], heap[minIndex]);
-            heapify(minIndex);
+        const std::size_t batch = heap.size() - oldSize;
+        if (batch * std::bit_width(heap.size()) > heap.size()) {
+            buildHeap();
+        } else {
+            for (std::size_t index = oldSize; index < heap.size(); ++index) {
+                siftUp(index);
+            }
         }
     }
 
-    // Function to print the heap
-    void printHeap() {
-        for (int i = 0; i < heap.size(); ++i) {
-            std::cout << heap[i] << " ";
+    // Floyd's bottom-up construction: sift down every internal node, starting
+    // from the last parent. Heaps with fewer than two elements are already
+    // ordered, which also keeps (size - 2) from wrapping around.
+    void buildHeap() {
+        if (heap.size() < 2) {
+            return;
+        }
+        for (std::size_t index = parent(heap.size() - 1) + 1; index-- > 0;) {
+            siftDown(index);
+        }
+    }
+
+    // Helper function to store an entry and keep its handle's position in sync
+    void place(std::size_t index, Entry&& entry) {
+        position[entry.handle] = index;
+        heap[index] = std::move(entry);
+    }
+
+    // Move the element at index up by shifting larger parents into the hole,
+    // so each level costs one move instead of a three-move swap.
+    void siftUp(std::size_t index) {
+        Entry hole = std::move(heap[index]);
+        while (index > 0) {
+            std::size_t parentIndex = parent(index);
+            if (!less(hole.value, heap[parentIndex].value)) {
+                break;
+            }
+            place(index, std::move(heap[parentIndex]));
+            index = parentIndex;
+        }
+        place(index, std::move(hole));
+    }
+
+    // Move the element at index down by pulling the smallest child into the hole
+    void siftDown(std::size_t index) {
+        const std::size_t count = heap.size();
+        Entry hole = std::move(heap[index]);
+        while (true) {
+            std::size_t child = firstChild(index);
+            if (child >= count) {
+                break;
+            }
+            std::size_t lastChild = std::min(child + Arity, count);
+            std::size_t minIndex = child;
+            for (std::size_t i = child + 1; i < lastChild; ++i) {
+                if (less(heap[i].value, heap[minIndex].value)) {
+                    minIndex = i;
+                }
+            }
+            if (!less(heap[minIndex].value, hole.value)) {
+                break;
+            }
+            place(index, std::move(heap[minIndex]));
+            index = minIndex;
+        }
+        place(index, std::move(hole));
+    }
+
+    void removeAt(std::size_t index) {
+        Handle handle = heap[index].handle;
+        position[handle] = npos;
+        freeHandles.push_back(handle);
+
+        if (index + 1 == heap.size()) {
+            heap.pop_back();
+            return;
+        }
+
+        // Fill the gap with the last element, which may belong above or below it
+        place(index, std::move(heap.back()));
+        heap.pop_back();
+        if (index > 0 && less(heap[index].value, heap[parent(index)].value)) {
+            siftUp(index);
+        } else {
+            siftDown(index);
         }
-        std::cout << std::endl;
     }
 };
 
-int main() {
-    MinHeap minHeap;
+//---------------------------------------------------------------------------
+// Benchmark: Dijkstra on a random graph (push / decreaseKey / deleteMin)
+//---------------------------------------------------------------------------
+
+struct Graph {
+    std::vector<std::uint32_t> offsets;
+    std::vector<std::uint32_t> targets;
+    std::vector<std::uint32_t> weights;
+};
+
+Graph makeRandomGraph(std::uint32_t vertices, std::uint32_t degree, std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<std::uint32_t> vertex(0, vertices - 1);
+    std::uniform_int_distribution<std::uint32_t> weight(1, 1000);
+
+    Graph graph;
+    graph.offsets.resize(vertices + 1);
+    graph.targets.resize(static_cast<std::size_t>(vertices) * degree);
+    graph.weights.resize(graph.targets.size());
+    for (std::uint32_t v = 0; v <= vertices; ++v) {
+        graph.offsets[v] = v * degree;
+    }
+    for (std::size_t e = 0; e < graph.targets.size(); ++e) {
+        graph.targets[e] = vertex(rng);
+        graph.weights[e] = weight(rng);
+    }
+    return graph;
+}
+
+using Distance = std::uint64_t;
+constexpr Distance unreachable = std::numeric_limits<Distance>::max();
+
+struct HeapOps {
+    std::uint64_t pushes = 0;
+    std::uint64_t decreases = 0;
+    std::uint64_t pops = 0;
+    std::uint64_t total() const { return pushes + decreases + pops; }
+};
+
+template <std::size_t Arity>
+std::vector<Distance> dijkstraIndexed(const Graph& graph, HeapOps& ops) {
+    using Item = std::pair<Distance, std::uint32_t>;
+    using Heap = MinHeap<Item, std::less<Item>, Arity>;
+
+    const std::uint32_t vertices = static_cast<std::uint32_t>(graph.offsets.size() - 1);
+    std::vector<Distance> dist(vertices, unreachable);
+    std::vector<typename Heap::Handle> handles(vertices);
+    std::vector<bool> queued(vertices, false);
+
+    Heap heap;
+    heap.reserve(vertices);
+    dist[0] = 0;
+    handles[0] = heap.insert({0, 0});
+    queued[0] = true;
+    ++ops.pushes;
+
+    while (!heap.empty()) {
+        auto [d, v] = heap.deleteMin();
+        queued[v] = false;
+        ++ops.pops;
+        for (std::uint32_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+            std::uint32_t to = graph.targets[e];
+            Distance candidate = d + graph.weights[e];
+            if (candidate >= dist[to]) {
+                continue;
+            }
+            if (queued[to]) {
+                heap.decreaseKey(handles[to], {candidate, to});
+                ++ops.decreases;
+            } else {
+                handles[to] = heap.insert({candidate, to});
+                queued[to] = true;
+                ++ops.pushes;
+            }
+            dist[to] = candidate;
+        }
+    }
+    return dist;
+}
+
+// Textbook alternative: std::priority_queue has no decrease-key, so every
+// improvement pushes a duplicate and stale entries are skipped when popped.
+std::vector<Distance> dijkstraLazy(const Graph& graph, HeapOps& ops) {
+    using Item = std::pair<Distance, std::uint32_t>;
+
+    const std::uint32_t vertices = static_cast<std::uint32_t>(graph.offsets.size() - 1);
+    std::vector<Distance> dist(vertices, unreachable);
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+
+    dist[0] = 0;
+    queue.push({0, 0});
+    ++ops.pushes;
+
+    while (!queue.empty()) {
+        auto [d, v] = queue.top();
+        queue.pop();
+        ++ops.pops;
+        if (d != dist[v]) {
+            continue;
+        }
+        for (std::uint32_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+            std::uint32_t to = graph.targets[e];
+            Distance candidate = d + graph.weights[e];
+            if (candidate < dist[to]) {
+                dist[to] = candidate;
+                queue.push({candidate, to});
+                ++ops.pushes;
+            }
+        }
+    }
+    return dist;
+}
+
+//---------------------------------------------------------------------------
+// Benchmark: loading timers one by one versus in bulk
+//---------------------------------------------------------------------------
+
+template <typename Heap>
+void reportBulkLoad(const char* name, const Heap& heap, std::chrono::duration<double> elapsed, std::uint64_t expectedMin) {
+    std::cout << name << ": " << elapsed.count() * 1000.0 << " ms";
+    if (heap.top() != expectedMin) {
+        std::cout << "  [MISMATCH]";
+    }
+    std::cout << std::endl;
+}
+
+void benchmarkBulkLoad(const char* label, const std::vector<std::uint64_t>& deadlines) {
+    const std::size_t count = deadlines.size();
+    std::uint64_t expectedMin = *std::min_element(deadlines.begin(), deadlines.end());
+    std::cout << "\nLoading " << count << " timers, " << label << std::endl;
+
+    {
+        MinHeap<std::uint64_t> heap;
+        heap.reserve(count);
+        auto start = std::chrono::steady_clock::now();
+        for (std::uint64_t deadline : deadlines) {
+            heap.insert(deadline);
+        }
+        reportBulkLoad("insert one by one   ", heap, std::chrono::steady_clock::now() - start, expectedMin);
+    }
+    {
+        MinHeap<std::uint64_t> heap;
+        auto start = std::chrono::steady_clock::now();
+        heap.insertBulk(deadlines.begin(), deadlines.end());
+        reportBulkLoad("insertBulk          ", heap, std::chrono::steady_clock::now() - start, expectedMin);
+    }
+    {
+        std::vector<std::uint64_t> copy = deadlines;
+        auto start = std::chrono::steady_clock::now();
+        MinHeap<std::uint64_t> heap(std::move(copy));
+        reportBulkLoad("constructor (Floyd) ", heap, std::chrono::steady_clock::now() - start, expectedMin);
+    }
+}
+
+template <typename Function>
+void runBenchmark(const char* name, Function run, const std::vector<Distance>* expected) {
+    HeapOps ops;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Distance> dist = run(ops);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << name << ": " << elapsed.count() * 1000.0 << " ms, "
+              << ops.total() << " heap ops (" << ops.pushes << " push, "
+              << ops.decreases << " decrease, " << ops.pops << " pop), "
+              << ops.total() / elapsed.count() / 1e6 << " Mops/s";
+    if (expected != nullptr && dist != *expected) {
+        std::cout << "  [MISMATCH]";
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    MinHeap<int> minHeap;
 
     minHeap.insert(10);
     minHeap.insert(5);
-    minHeap.insert(30);
+    auto thirty = minHeap.insert(30);
     minHeap.insert(2);
-    minHeap.insert(1);
+    auto one = minHeap.insert(1);
 
-    std::cout << "Initial Heap: ";
+    std::cout << "Min Heap: ";
     minHeap.printHeap();
 
-    minHeap.buildHeap();
-    std::cout << "Min Heap: ";
+    minHeap.decreaseKey(thirty, 0);
+    std::cout << "After lowering 30 to 0: ";
+    minHeap.printHeap();
+
+    minHeap.erase(one);
+    std::cout << "After erasing 1 by handle: ";
     minHeap.printHeap();
 
     minHeap.deleteMin();
@@ -115,61 +466,117 @@ int main() {
     std::cout << "Min Heap after deleting two smallest elements: ";
     minHeap.printHeap();
 
+    MinHeap<int> built({10, 5, 30, 2, 1});
+    std::cout << "Heap built in O(n) from {10, 5, 30, 2, 1}: ";
+    built.printHeap();
+
+    std::vector<int> batch = {7, 3, 9};
+    built.insertBulk(batch.begin(), batch.end());
+    std::cout << "After insertBulk {7, 3, 9}: ";
+    built.printHeap();
+
+    MinHeap<int> single({42});
+    std::cout << "Single-element heap: ";
+    single.printHeap();
+
+    try {
+        minHeap.decreaseKey(one, -1);
+    } catch (const std::out_of_range& e) {
+        std::cerr << "Expected error: " << e.what() << std::endl;
+    }
+
+    // About 3.5M vertices with 8 out-edges each gives roughly 10M heap operations
+    std::uint32_t vertices = argc > 1 ? static_cast<std::uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 3500000;
+    std::uint32_t degree = 8;
+    Graph graph = makeRandomGraph(vertices, degree, 42);
+    std::cout << "\nDijkstra on " << vertices << " vertices, " << graph.targets.size() << " edges" << std::endl;
+
+    HeapOps warmup;
+    std::vector<Distance> expected = dijkstraLazy(graph, warmup);
+
+    runBenchmark("std::priority_queue (lazy)", [&](HeapOps& ops) { return dijkstraLazy(graph, ops); }, nullptr);
+    runBenchmark("MinHeap<2> indexed     ", [&](HeapOps& ops) { return dijkstraIndexed<2>(graph, ops); }, &expected);
+    runBenchmark("MinHeap<4> indexed     ", [&](HeapOps& ops) { return dijkstraIndexed<4>(graph, ops); }, &expected);
+
+    std::size_t timers = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 50000000;
+    std::vector<std::uint64_t> deadlines(timers);
+    std::mt19937_64 rng(7);
+    for (std::uint64_t& deadline : deadlines) {
+        deadline = rng();
+    }
+    benchmarkBulkLoad("random deadlines", deadlines);
+
+    // Descending input is the worst case for one-by-one insertion: every new
+    // element is the new minimum and sifts all the way up to the root.
+    std::sort(deadlines.begin(), deadlines.end(), std::greater<std::uint64_t>());
+    benchmarkBulkLoad("descending deadlines", deadlines);
+
     return 0;
 }
 ```
 
-This C++ code provides a basic implementation of a Min Heap data structure. The Min Heap is a complete binary tree where every key is less than or equal to its parent key, ensuring that the minimum value in the heap is always at the root.
+This C++ code provides an implementation of an indexed Min Heap: a priority queue that, besides the usual insert and delete-minimum operations, can lower the key of an element or remove it from the middle of the heap. The Min Heap is a complete tree where every key is less than or equal to the keys of its children, ensuring that the minimum value in the heap is always at the root.
+
+The code is divided into four main parts:
 
-The code is divided into two main parts:
+1. The MinHeap class template: The element type, the comparison function and the number of children per node (the arity) are all template parameters, so the same class works as a binary heap of `int` or a 4-ary heap of `(distance, vertex)` pairs. `insert` returns a handle which `decreaseKey`, `erase`, `value` and `contains` accept later on.
 
-1. The MinHeap class: This class contains the Min Heap implementation. It has several private helper functions to find the parent, left, and right nodes. The MinHeap class has public functions to build the heap (`buildHeap`), insert an element (`insert`), delete and return the minimum element (`deleteMin`), heapify (`heapify`), and print the heap (`printHeap`).
+2. The benchmark: Dijkstra's shortest-path algorithm is run on a random graph with about three and a half million vertices. This is the classic workload for a priority queue with decrease-key, and it produces roughly ten million push, decrease and pop operations. The same search is run with `std::priority_queue`, which has no decrease-key and therefore has to push duplicates and skip stale entries, and the distances of both versions are compared. The indexed heap performs fewer operations, but every move also writes to the `position` array, so on random graphs the lazy queue can still win on raw speed; the 4-ary heap narrows that gap.
 
-2. The main function: This function demonstrates how to use the MinHeap class. It creates a MinHeap object, inserts several elements, builds the heap, prints the heap, deletes two smallest elements, and prints the heap again.
+3. The bulk-load benchmark: Fifty million timer deadlines are loaded three ways: with one `insert` per element, with `insertBulk`, and with the constructor that takes a whole vector. It runs once with random deadlines and once with descending deadlines, the worst case for one-by-one insertion. The number of timers can be passed as the second command line argument.
+
+4. The main function: It demonstrates inserting, lowering a key, erasing by handle and deleting the minimum, shows the exception thrown for a stale handle, and then runs the benchmark. The number of vertices can be passed as the first command line argument.
 
 The code matters for several reasons:
 
-1. Understanding data structures and algorithms: Implementing the Min Heap from scratch helps you understand how this data structure works internally and how it can be used in practice. This knowledge is crucial for designing efficient algorithms and choosing the appropriate data structures for different problems.
+1. Real priority queues need decrease-key: Schedulers, Dijkstra and Prim's algorithm all change the priority of items that are already queued. Without handles the only options are an O(n) search for the element or leaving stale duplicates in the heap.
+
+2. Generic code: Templates let one well-tested heap serve every element type and ordering instead of copying a separate `int` heap for each use.
+
+3. Performance details: The sift loops move a "hole" through the tree instead of swapping, and a 4-ary heap is shallower than a binary heap, which usually makes it faster on large inputs because each level touches one cache line of children.
 
-2. Solving complex problems: Min Heaps are used in many applications, such as finding the kth smallest/largest values, constructing priority queues, and applying different variants of the Huffman coding algorithm. Implementing the Min Heap data structure yourself allows you to tackle these complex problems.
+4. Error handling: Invalid operations throw `std::out_of_range` or `std::invalid_argument` instead of terminating the whole program with `exit`, so the caller decides how to recover.
 
-3. Debugging and optimizing: Implementing Min Heap from scratch provides an opportunity to dive deeper into the code, identify bottlenecks, and optimize the algorithm yourself, which is a valuable skill for a software developer.
+Here's a breakdown of the concepts used in the code:
 
-4. Learning and Practice: This code snippet can serve as a good starting point as you continue to learn more complex data structures and algorithms, allowing you to practice your programming skills while building a robust understanding of computer science fundamentals.
+1. `template <typename T, typename Compare = std::less<T>, std::size_t Arity = 2>`: The heap is a class template. `Compare` defaults to `std::less<T>`, which gives a min-heap; passing `std::greater<T>` would turn it into a max-heap. `Arity` is a non-type template parameter checked with `static_assert`.
 
-The provided C++ code is an implementation of a Min Heap data structure. Here's a breakdown of the concepts used in the code:
+2. Storage: The heap is a `std::vector<Entry>`, where each entry holds the value and the handle it belongs to. A second vector, `position`, maps every handle to the index of its entry, and `freeHandles` recycles handles of elements that have left the heap.
 
-1. `#include <iostream>` and `#include <vector>`: These are standard C++ libraries used for input/output operations and creating a dynamic array (vector) to store the elements of the heap.
+3. Navigation helpers:
+   - `parent(index)` returns `(index - 1) / Arity`.
+   - `firstChild(index)` returns `Arity * index + 1`; the children of a node are stored next to each other.
+   These helpers no longer do bounds checks of their own. The sift loops only call them with indices they have already checked, which also removes the old bug where index 0 was rejected as invalid.
 
-2. `MinHeap` class: This is the main class for the Min Heap implementation. It includes a private `std::vector<int>` named `heap` to store the heap elements.
+4. `siftUp` and `siftDown`: Both functions move the element out of the heap into a local variable (the "hole"), shift parents down or the smallest child up until the right spot is found, and then place the element once. They are plain loops, so deep heaps cannot overflow the call stack the way a recursive `heapify` could.
 
-3. Helper functions:
-   - `parent(int index)`: This function returns the index of a node's parent node.
-   - `leftChild(int index)` and `rightChild(int index)`: These functions return the indices of a node's left and right child nodes, respectively.
+5. `buildHeap()`: Floyd's bottom-up construction. Starting from the last node that has children, every node is sifted down. Most nodes sit near the bottom of the tree and only move a level or two, which is why the total cost is O(n) instead of the O(n log n) of n separate inserts. Heaps with fewer than two elements are returned early.
 
-4. Public functions of the MinHeap class:
-   - `buildHeap()`: This function constructs a Min Heap from an initially unsorted vector. It does this by repeatedly calling the `heapify()` function, starting from the last parent node and moving back up the tree.
-   - `insert(int element)`: This function inserts a new element into the Min Heap. It first adds the new element to the heap, then adjusts the position of the added element up the heap by repeatedly swapping the added element with its parent until it is in its correct position.
-   - `deleteMin()`: This function deletes and returns the smallest element in the Min Heap. It does this by first swapping the smallest element with the last element in the heap, then adjusting the position of the deleted element by re-heapifying the Min Heap, starting from its new position.
-   - `heapify(int index)`: This is a helper function used by `buildHeap()` and `deleteMin()`. It adjusts the position of a given element (index) in the heap, ensuring that the Min Heap property is maintained.
-   - `printHeap()`: This function prints the elements of the Min Heap to the console.
+6. `place(index, entry)`: Every time an entry is stored, its handle's position is updated. This single helper is what keeps handles valid while elements move around.
 
-5. `main()` function: This is the main entry point of the program. It creates a Min Heap object, inserts some elements, constructs a Min Heap, deletes and prints elements, and finally terminates the program.
+7. Public functions of the MinHeap class:
+   - `insert(element)`: Appends the element, sifts it up and returns its handle.
+   - `deleteMin()`: Returns the smallest element and fills the root with the last element.
+   - `MinHeap(std::vector<T> elements)`: Builds a heap from existing data in O(n) with `buildHeap`. The element at index i of the vector gets handle i.
+   - `insertBulk(first, last)`: Appends a batch of elements. If the batch is large compared to the heap (more than size / log2(size) elements), it rebuilds the whole heap bottom-up; otherwise it sifts up only the new elements. An overload also returns the new handles.
+   - `decreaseKey(handle, element)`: Replaces the element's key with a smaller one and sifts it up.
+   - `erase(handle)`: Removes an element from anywhere in the heap. The last element is moved into the gap and sifted up or down, whichever restores the heap order.
+   - `top()`, `size()`, `empty()`, `reserve()` and `printHeap()` are small helpers.
 
-From  C++ code, here are some common beginner mistakes that can be avoided:
+8. Benchmark helpers: The graph is stored in compressed sparse row form (`offsets`, `targets`, `weights`), `std::chrono::steady_clock` measures elapsed time and `HeapOps` counts each kind of heap operation so the throughput can be reported in millions of operations per second.
 
-1. **Uninitialized Variables**: Ensure all your variables are initialized before use, especially in your helper functions such as `parent`, `leftChild`, and `rightChild`. If the index is not valid, it's better to return an error or throw an exception rather than crashing the program.
+From this C++ code, here are some common beginner mistakes that can be avoided:
 
-2. **Boundary Checking**: Make sure to add checks for bounds in places where you might be passing an invalid index. For example, in the `printHeap` function, it's good practice to check if the `i` variable is less than the vector's size before trying to access it.
+1. **Forgetting to update positions**: In an indexed heap, every move of an element must also update its entry in `position`. Writing `heap[i] = heap[j]` directly instead of going through `place` silently breaks every handle that points at those elements.
 
-3. **Efficient Error Handling**: Instead of using `std::cerr` and `exit(EXIT_FAILURE)`, consider using exceptions or return error codes to handle errors in a more elegant and structured manner.
+2. **Using a handle after its element is gone**: Once an element has been removed by `deleteMin` or `erase`, its handle may be reused by a later `insert`. Keep track of which handles are still live, as the benchmark does with the `queued` vector.
 
-4. **Code Readability**: Improve code readability by adding comments and function documentation. This will make it easier for others (or even yourself in the future) to understand what each function does and how it works.
+3. **Increasing a key with decreaseKey**: `decreaseKey` only sifts up. A larger key would leave the heap out of order, which is why the function throws `std::invalid_argument` in that case; use `erase` followed by `insert` instead.
 
-5. **Empty Container Check**: In the `deleteMin` function, make sure to check whether the heap is empty before trying to delete an element.
+4. **Unsigned underflow**: Index arithmetic uses `std::size_t`. Expressions such as `(size() - 2) / 2` wrap around to a huge number when the heap has fewer than two elements, so `buildHeap` checks the size before subtracting and counts down with `index-- > 0` instead of `index >= 0`, which is always true for an unsigned type.
 
-6. **Consistent Indices**: In the function `heapify`, the parent index is written as `(index - 1) / 2`, but in other parts of the code it's written as `(i - 1) / 2`. Make sure to use a consistent notation to avoid confusion.
+5. **Stopping the program on errors**: Calling `exit(EXIT_FAILURE)` from a helper function makes the class impossible to reuse. Throwing an exception lets the caller decide what to do.
 
-7. **Check for heap invariant**: In the constructor method `buildHeap`, you're trying to heapify the elements starting at the last non-leaf index. But in the real implementation, the heap should be initialized with an already sorted list, in which case, you don't need to build the heap.
+6. **Growing the vector one element at a time**: Loading millions of elements without `reserve` makes the vector reallocate and copy everything repeatedly. `insertBulk` reserves space up front whenever it can measure the input range.
 
-8. **Semicolon Missing**: At the end of the `leftChild`, `rightChild`, and `parent` helper functions, you missed an ending semicolon (`;`).
\ No newline at end of file
+7. **Benchmarking without checking results**: A fast benchmark that computes the wrong answer is worthless. The benchmark compares the distances from every heap variant with the `std::priority_queue` result and prints `[MISMATCH]` if they differ.
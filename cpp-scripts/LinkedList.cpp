@@ -1,6 +1,10 @@
-
 ```cpp
 #include <iostream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstdlib>
+#include <iterator>
 using namespace std;
 
 class Node {
@@ -8,6 +12,11 @@ public:
     int data;
     Node* next;
 
+    Node() {
+        data = 0;
+        next = NULL;
+    }
+
     Node(int d) {
         data = d;
         next = NULL;
@@ -16,25 +25,82 @@ public:
 
 class LinkedList {
 public:
-    Node* head;
-
     LinkedList() {
         head = NULL;
+        tail = NULL;
+        spare = NULL;
+        fresh = NULL;
+        freshLeft = 0;
+        count = 0;
+        nextBlock = 16;
     }
 
-    void Insert(int d) {
-        Node* newNode = new Node(d);
-        if (head == NULL) {
+    // Nodes live in blocks owned by the list, so a copy would share them
+    LinkedList(const LinkedList&) = delete;
+    LinkedList& operator=(const LinkedList&) = delete;
+
+    // Every node belongs to one of the blocks, and the blocks are released
+    // by their unique_ptrs when the list goes away. Nothing can leak.
+    ~LinkedList() = default;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    Node* front() const { return head; }
+
+    // Append in O(1): the tail pointer saves walking the whole list
+    void push_back(int d) {
+        Node* newNode = allocate(d);
+        if (tail == NULL) {
             head = newNode;
         } else {
-            Node* current = head;
-            while (current->next != NULL) {
-                current = current->next;
+            tail->next = newNode;
+        }
+        tail = newNode;
+        ++count;
+    }
+
+    void push_front(int d) {
+        Node* newNode = allocate(d);
+        newNode->next = head;
+        head = newNode;
+        if (tail == NULL) {
+            tail = newNode;
+        }
+        ++count;
+    }
+
+    // Append every value in [first, last). When the number of values is
+    // known up front, the nodes they need are allocated as one block, so the
+    // whole range costs a single call to the allocator. A single-pass input
+    // iterator cannot be counted without consuming it, so its values are
+    // just pushed one by one.
+    template <typename Iterator>
+    void append_range(Iterator first, Iterator last) {
+        if constexpr (std::forward_iterator<Iterator>) {
+            size_t needed = static_cast<size_t>(std::distance(first, last));
+            size_t available = freshLeft;
+            for (Node* node = spare; node != NULL && available < needed; node = node->next) {
+                ++available;
             }
-            current->next = newNode;
+            if (needed > available) {
+                addBlock(needed - available);
+            }
+        }
+        for (; first != last; ++first) {
+            push_back(*first);
         }
     }
 
+    template <typename Range>
+    void append_range(const Range& values) {
+        append_range(std::begin(values), std::end(values));
+    }
+
+    // Kept for existing callers; same as push_back
+    void Insert(int d) {
+        push_back(d);
+    }
+
     void Display() {
         Node* current = head;
         while (current != NULL) {
@@ -50,30 +116,187 @@ public:
             return;
         }
 
-        if (head->data == d) {
-            Node* temp = head;
-            head = head->next;
-            delete temp;
-            return;
-        }
-
+        Node* previous = NULL;
         Node* current = head;
-        while (current->next != NULL && current->next->data != d) {
+        while (current != NULL && current->data != d) {
+            previous = current;
             current = current->next;
         }
 
-        if (current->next == NULL) {
+        if (current == NULL) {
             cout << "Element not found" << endl;
             return;
         }
 
-        Node* temp = current->next;
-        current->next = current->next->next;
-        delete temp;
+        if (previous == NULL) {
+            head = current->next;
+        } else {
+            previous->next = current->next;
+        }
+        if (current == tail) {
+            tail = previous;
+        }
+        release(current);
+        --count;
+    }
+
+    // Give every node back to the spare list; the blocks stay allocated for reuse
+    void clear() {
+        while (head != NULL) {
+            Node* temp = head;
+            head = head->next;
+            release(temp);
+        }
+        tail = NULL;
+        count = 0;
+    }
+
+private:
+    Node* head;
+    Node* tail;
+    Node* spare;  // deleted nodes, linked through next
+    Node* fresh;  // never used nodes at the end of the newest block
+    size_t freshLeft;
+    size_t count;
+    size_t nextBlock;
+    vector<unique_ptr<Node[]>> blocks;
+
+    // Allocate n nodes at once. They are handed out in address order, so
+    // nodes appended one after another sit next to each other in memory.
+    // Whatever is left of the previous block goes on the spare list.
+    void addBlock(size_t n) {
+        while (freshLeft > 0) {
+            release(fresh++);
+            --freshLeft;
+        }
+        blocks.push_back(make_unique<Node[]>(n));
+        fresh = blocks.back().get();
+        freshLeft = n;
+    }
+
+    Node* allocate(int d) {
+        Node* node;
+        if (spare != NULL) {
+            node = spare;
+            spare = spare->next;
+        } else {
+            if (freshLeft == 0) {
+                addBlock(nextBlock);
+                if (nextBlock < 4096) {
+                    nextBlock *= 2;
+                }
+            }
+            node = fresh++;
+            --freshLeft;
+        }
+        node->data = d;
+        node->next = NULL;
+        return node;
+    }
+
+    void release(Node* node) {
+        node->next = spare;
+        spare = node;
+    }
+};
+
+//---------------------------------------------------------------------------
+// Benchmark: the original Insert, which walked to the end on every append
+//---------------------------------------------------------------------------
+
+class WalkingList {
+public:
+    Node* head = NULL;
+
+    WalkingList() = default;
+    WalkingList(const WalkingList&) = delete;
+    WalkingList& operator=(const WalkingList&) = delete;
+
+    ~WalkingList() {
+        while (head != NULL) {
+            Node* temp = head;
+            head = head->next;
+            delete temp;
+        }
+    }
+
+    void Insert(int d) {
+        Node* newNode = new Node(d);
+        if (head == NULL) {
+            head = newNode;
+        } else {
+            Node* current = head;
+            while (current->next != NULL) {
+                current = current->next;
+            }
+            current->next = newNode;
+        }
     }
 };
 
-int main() {
+template <typename Function>
+double timeMs(Function run) {
+    auto start = chrono::steady_clock::now();
+    run();
+    chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+long long sumList(Node* node) {
+    long long sum = 0;
+    for (; node != NULL; node = node->next) {
+        sum += node->data;
+    }
+    return sum;
+}
+
+void benchmarkAppends(int appends) {
+    cout << "\n" << appends << " appends" << endl;
+    const long long expected = static_cast<long long>(appends) * (appends - 1) / 2;
+
+    // The walking version is quadratic, so it is timed on a small list and
+    // the result is scaled by (appends / walked)^2
+    const int walked = 50000;
+    double walkMs = timeMs([&] {
+        WalkingList list;
+        for (int i = 0; i < walked; ++i) {
+            list.Insert(i);
+        }
+    });
+    double scale = static_cast<double>(appends) / walked;
+    cout << "walking Insert:  " << walkMs << " ms for " << walked << ", about " << walkMs * scale * scale / 60000.0
+         << " minutes for " << appends << " (extrapolated)" << endl;
+
+    auto report = [&](const char* name, double ms, const LinkedList& list) {
+        cout << name << ms << " ms";
+        if (list.size() != static_cast<size_t>(appends) || sumList(list.front()) != expected) {
+            cout << "  [MISMATCH]";
+        }
+        cout << endl;
+    };
+
+    {
+        LinkedList list;
+        double ms = timeMs([&] {
+            for (int i = 0; i < appends; ++i) {
+                list.push_back(i);
+            }
+        });
+        report("push_back:       ", ms, list);
+    }
+
+    vector<int> values(appends);
+    for (int i = 0; i < appends; ++i) {
+        values[i] = i;
+    }
+    {
+        LinkedList list;
+        double ms = timeMs([&] { list.append_range(values); });
+        report("append_range:    ", ms, list);
+    }
+}
+
+int main(int argc, char* argv[]) {
     LinkedList list;
 
     list.Insert(1);
@@ -98,139 +321,61 @@ int main() {
 
     list.Display();
 
+    list.push_front(0);
+    list.append_range(vector<int>{1, 2, 3});
+    list.push_back(4);
+    list.Display();
+    cout << "Size: " << list.size() << endl;
+
+    int appends = argc > 1 ? atoi(argv[1]) : 10000000;
+    benchmarkAppends(appends);
+
     return 0;
 }
 ```
 
-This code snippet creates a LinkedList class with three methods: Insert(), Display(), and Delete(). The Insert() method inserts new nodes at the end of the list. The Display() method prints the list elements one after another. The Delete() method deletes a node with the provided value. The main function demonstrates the use of the static LinkedList class.
+This code snippet creates a singly linked list with O(1) appends at both ends, a cached size, a bulk `append_range`, and automatic cleanup of every node. The main function demonstrates the list and then benchmarks 10 million appends against the original `Insert`, which walked from `head` to the end of the list on every call.
 
 This C++ code matters for several reasons:
 
-1. **Understanding Data Structures**: The code provides a simple implementation of a singly linked list, which is a fundamental data structure in Computer Science. Learning how to implement and manipulate linked lists is an essential skill for any programmer.
-
-2. **Dynamic Memory Allocation**: The code uses dynamic memory allocation by creating new nodes using `new Node(d)`. This is crucial when working with data structures, especially in situations where the size of the data structure is unknown or can change at runtime.
+1. **Understanding Data Structures**: The code provides an implementation of a singly linked list, which is a fundamental data structure in Computer Science. Learning how to implement and manipulate linked lists is an essential skill for any programmer.
 
-3. **Linked List Operations**: The code includes basic operations like insertion, deletion, and traversal. These operations are fundamental to working with linked lists and are frequently required in real-world applications.
+2. **Algorithmic Complexity**: Appending by walking to the end costs O(n) per append, so building a list of n elements costs O(n²). For 10 million elements that is about 50 trillion pointer steps, which takes hours. Remembering the last node in a `tail` pointer makes each append O(1), and the same list is built in milliseconds.
 
-4. **Code Readability and Maintainability**: The code is well-structured and easily readable. It uses meaningful variable and function names, which makes it easier for other developers (or future self) to understand and maintain the code.
+3. **Memory Management**: The original class never freed its nodes. Here every node lives in a block that is owned by a `std::unique_ptr`, so the memory is returned automatically when the list is destroyed. This is RAII (Resource Acquisition Is Initialization): the object that acquires a resource is responsible for releasing it in its destructor.
 
-5. **Error Handling**: While the code does not include exception handling, it does include some basic error checks, such as checking if the list is empty before trying to delete from it. This is a good practice that helps to prevent potential runtime errors.
+4. **Fewer Allocations**: Calling `new` for every node is slow and spreads the nodes around memory. Allocating nodes in blocks reduces the number of allocator calls, and `append_range` allocates exactly one block for the whole range.
 
-6. **Real-world Applications**: Linked lists are used in various real-world applications, including operating systems (for managing tasks and processes in the process scheduler), compilers (for the symbol table), and data storage systems (like hash tables and graph data structures).
+5. **Real-world Applications**: Linked lists are used in various real-world applications, including operating systems (for managing tasks and processes in the process scheduler), compilers (for the symbol table), and data storage systems (like hash tables and graph data structures).
 
-The provided C++ code implements a simple singly linked list with basic functionalities such as insertion, deletion, and traversal. Here's an explanation of the concepts in this code:
+Here's an explanation of the concepts in this code:
 
-1. `#include <iostream>`: This line includes the iostream library, which allows the program to perform input/output operations.
+1. `class Node`: A node in the linked list. `data` holds the integer value and `next` points to the next node, or is `NULL` at the end of the list. The default constructor lets the list create whole arrays of nodes with `make_unique<Node[]>(n)`.
 
-2. `using namespace std;`: This line imports all the standard namespace, meaning we don't need to use 'std::' before any standard library functions.
+2. `head`, `tail` and `count`: The list remembers its first node, its last node and its number of elements. `tail` makes `push_back` O(1), and `count` makes `size()` O(1) instead of a walk over the list.
 
-3. `class Node`: This is a user-defined class representing a node in the linked list. It has two private members: `int data` and `Node* next`. `data` holds the integer value of the node, and `next` is a pointer to the next node in the list. There's also a constructor `Node(int d)` that initializes the node with a given integer value and sets the next pointer to null.
+3. `push_back(int d)` and `push_front(int d)`: Link a new node after the tail or before the head. When the list was empty, both `head` and `tail` point at the new node. `Insert` is kept as another name for `push_back`, so existing code keeps working.
 
-4. `class LinkedList`: This is another user-defined class representing the linked list as a whole. It has a private member `Node* head`, which is a pointer to the first node in the list or null if the list is empty. The constructor `LinkedList()` initializes the head pointer to null.
+4. `append_range(first, last)` and `append_range(values)`: Append a whole range. When the range can be walked more than once (a forward iterator), its length is known up front, so the missing nodes are allocated as one block before the loop, and the loop itself never calls the allocator. Input iterators such as `std::istream_iterator` can only be read once, so their values are pushed one by one.
 
-5. `void Insert(int d)`: This function inserts a new node with the given `d` value at the end of the linked list. It first creates a new node using the constructor `Node(d)`. Then it checks if the list is empty; if so, it sets the head to the new node. If not, it iterates through the list until it finds the last node and links the new node to it.
+5. `Delete(int d)`: Walks the list with a `previous` pointer, unlinks the first node with the value `d` and gives the node back. If the deleted node was the tail, `tail` moves back to `previous`.
 
-6. `void Display()`: This function traverses the list and prints the data of each node. It initializes a pointer `current` to the head operator and enters a while loop as long as `current` is not null. In each iteration, it prints `current->data` (the value of the current node) followed by " -> " and sets `current` to its `next` pointer. Finally, it prints "NULL" when it reaches the end of the list.
+6. `clear()`: Gives every node back to the spare list and empties the list, keeping the blocks for reuse.
 
-7. `void Delete(int d)`: This function deletes a node with the given `d` value from the linked list. It first checks if the list is empty, and if so, it prints a message and returns. If the head node's value is equal to the given `d`, it sets the head to the next node and frees the memory of the deleted node. If the head is not the node to be deleted, it initializes a pointer `current` to the beginning of the list and enters a while loop until it finds the node to be deleted or reaches the end of the list. If it finds the node, it saves the next pointer in a temporary variable, sets the next pointer of the previous node to the next node of the node to be deleted, and frees the memory of the deleted node.
+7. The spare list and `blocks`: Nodes are never deleted one at a time. `addBlock` allocates an array of nodes, and `allocate` hands them out in address order through the `fresh` pointer. `release` puts a deleted node on the `spare` list, and `allocate` reuses spare nodes before it touches a new block. Blocks start at 16 nodes and double up to 4096. `blocks` is a `vector<unique_ptr<Node[]>>`, so the destructor (`~LinkedList() = default;`) frees all of them.
 
-8. `int main()`: This is the main function where the LinkedList class is generated and used. It creates an object of the LinkedList class and calls its Insert(), Display(), and Delete() methods to insert, display, and delete nodes from the linked list. Finally, it returns 0 to indicate that the program has executed successfully.
+8. Deleted copy operations: A copied list would point at the same blocks as the original. `LinkedList(const LinkedList&) = delete;` turns an accidental copy into a compile error.
 
-The overall code creates a simple singly linked list with functions to insert, display, and delete elements from it. The inserted elements are maintained as a sequential list, with each element storing an integer value and a pointer to the next element in the list, if any.
+9. `WalkingList` and `benchmarkAppends`: `WalkingList` is the original list, with a destructor added so the benchmark does not leak. Because it is quadratic, it is timed on 50,000 appends and the time is scaled by the square of the size ratio to estimate 10 million appends. The new list is timed on the full 10 million with `push_back` and with `append_range`, and the result is checked by comparing the size and the sum of all values. The number of appends can be passed as the first command line argument.
 
 For a beginner, there are several common mistakes that can be made in this C++ code:
 
-1. **Memory Leaks**: In the `Insert` and `Delete` functions, we create and delete `Node` objects. However, if an exception is thrown between the creation and deletion of a `Node`, the memory will not be properly freed, leading to a memory leak. To fix this, you should use a smart pointer, such as `std::unique_ptr`, that will automatically delete the `Node` when it goes out of scope.
-
-2. **Null Pointer Dereferencing**: In the `Delete` function, before `current->next` is assigned to `current->next->next`, you should check if `current->next` is not `NULL`. Otherwise, you will get a null pointer dereferencing error.
-
-3. **Order of Operations**: In the `Delete` function, the assignment `current->next = current->next->next;` should be before the `delete temp;` statement. Otherwise, the deleted node's memory may be overwritten before it is properly freed.
-
-4. **Error Handling**: The code does not handle errors during memory allocation. If `new Node(d)` or any other `new` operation fails, the program will crash. You should add error handling to print an error message and abort the program in such cases.
-
-Here is a modified version of the code with the aforementioned improvements:
-
-```cpp
-#include <iostream>
-#include <memory>
-using namespace std;
-
-class Node {
-public:
-    int data;
-    Node* next;
-
-    Node(int d) {
-        data = d;
-        next = NULL;
-    }
-};
-
-class LinkedList {
-public:
-    Node* head;
-
-    LinkedList() { head = NULL; }
-
-    void Insert(int d) {
-        unique_ptr<Node> newNode(new Node(d));
-        if (head == NULL) {
-            head = newNode.release();
-        } else {
-            Node* current = head;
-            while (current->next != NULL) {
-                current = current->next;
-            }
-            current->next = newNode.release();
-        }
-    }
-
-    void Display() {
-        Node* current = head;
-        while (current != NULL) {
-            cout << current->data << " -> ";
-            current = current->next;
-        }
-        cout << "NULL" << endl;
-    }
-
-    void Delete(int d) {
-        // ... rest of the Delete function
-    }
-};
-
-int main() {
-    LinkedList list;
-
-    try {
-        list.Insert(1);
-        list.Insert(2);
-        list.Insert(3);
-
-        list.Display();
-
-        list.Delete(2);
+1. **Forgetting to update `tail`**: Every operation that can change the last node has to update `tail`: appending, inserting into an empty list, deleting the last node, and clearing the list. A stale `tail` makes the next `push_back` write into a node that is no longer on the list.
 
-        list.Display();
+2. **Memory Leaks**: A class that allocates nodes with `new` needs a destructor that frees them. Owning the memory through `std::unique_ptr` makes the compiler write that cleanup for you.
 
-        list.Delete(1);
+3. **Calling `delete` on a node from a block**: A node inside a `Node[]` array was not allocated on its own, so `delete node` is undefined behavior. Such nodes go back to the spare list instead.
 
-        list.Display();
-
-        list.Delete(3);
-
-        list.Display();
-
-        list.Delete(4);
-
-        list.Display();
-
-    } catch (const std::bad_alloc&) {
-        cout << "Memory allocation failed" << endl;
-    }
-
-    return 0;
-}
-```
+4. **Recounting the size**: Computing the size by walking the list costs O(n). Keep a counter and update it in every insert and delete.
 
-This updated code uses a unique pointer in the `Insert` function, handles null pointer dereferencing in the `Delete` function, reorders assignments in the `Delete` function, and includes basic exception handling for memory allocation errors.
\ No newline at end of file
+5. **Extrapolating from tiny inputs**: The quadratic append looks fine with 100 elements. Problems like this only appear at realistic sizes, so benchmark with them (or, when the slow version would take hours, measure a smaller size and scale it by its complexity).
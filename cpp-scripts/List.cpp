@@ -1,5 +1,17 @@
 ```cpp
 #include <iostream>
+#include <list>
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <iterator>
+#include <unordered_map>
+#include <random>
+#include <stdexcept>
+#include <cstdlib>
 
 class Node {
 public:
@@ -7,84 +19,486 @@ public:
     Node* next;
     Node* prev;
 
-    Node(int data) : data(data), next(nullptr), prev(nullptr) {}
+    Node() : data(0), next(nullptr), prev(nullptr) {}
+};
+
+// Hands out Nodes from chunks it owns. Released nodes go on a free list and
+// are reused by the next allocation, so a list that churns at a steady size
+// stops calling the allocator once it has warmed up. A pool can be shared by
+// several lists, which lets them splice nodes between each other; all chunks
+// are freed together when the last list using the pool goes away. Chunks come
+// from a std::pmr::memory_resource, the global heap unless another one is
+// given.
+class NodePool {
+public:
+    explicit NodePool(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : allocator(resource), chunks(resource) {}
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    // Nodes are trivially destructible, so giving the chunks back is enough
+    ~NodePool() {
+        for (const Chunk& chunk : chunks) {
+            allocator.deallocate(chunk.nodes, chunk.size);
+        }
+    }
+
+    Node* allocate(int data) {
+        if (freeList == nullptr) {
+            grow();
+        }
+        Node* node = freeList;
+        freeList = node->next;
+        node->data = data;
+        node->next = nullptr;
+        node->prev = nullptr;
+        return node;
+    }
+
+    void release(Node* node) {
+        node->next = freeList;
+        freeList = node;
+    }
+
+    // Number of nodes the pool has obtained from the allocator so far
+    std::size_t capacity() const { return reserved; }
+
+    std::pmr::memory_resource* resource() const { return allocator.resource(); }
+
+private:
+    static constexpr std::size_t firstChunkSize = 16;
+    static constexpr std::size_t maxChunkSize = 4096;
+
+    struct Chunk {
+        Node* nodes;
+        std::size_t size;
+    };
+
+    std::pmr::polymorphic_allocator<Node> allocator;
+    std::pmr::vector<Chunk> chunks;
+    std::size_t nextChunkSize = firstChunkSize;
+    std::size_t reserved = 0;
+    Node* freeList = nullptr;
+
+    // Chunks double in size up to a cap, and their nodes are threaded onto the
+    // free list in address order so consecutive inserts get adjacent nodes.
+    // The chunk list is reserved before the allocation, so push_back cannot
+    // throw after it, and geometrically: growing it by one each time would
+    // leave every superseded copy behind in a monotonic arena.
+    void grow() {
+        if (chunks.size() == chunks.capacity()) {
+            chunks.reserve(std::max(2 * chunks.size(), std::size_t{8}));
+        }
+        Node* chunk = allocator.allocate(nextChunkSize);
+        std::uninitialized_default_construct_n(chunk, nextChunkSize);
+        for (std::size_t i = nextChunkSize; i-- > 0;) {
+            chunk[i].next = freeList;
+            freeList = &chunk[i];
+        }
+        reserved += nextChunkSize;
+        chunks.push_back(Chunk{chunk, nextChunkSize});
+        nextChunkSize = std::min(nextChunkSize * 2, maxChunkSize);
+    }
 };
 
 class List {
 private:
     Node* head;
     Node* tail;
+    std::size_t count;
+    std::shared_ptr<NodePool> pool;
 
 public:
-    List() : head(nullptr), tail(nullptr) {}
+    // Bidirectional iterator over the list. It doubles as a handle: it stays
+    // valid until its node is erased, even when other nodes are inserted,
+    // erased or spliced, and even when its own node is spliced to another list.
+    class iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = int*;
+        using reference = int&;
+
+        iterator() = default;
+
+        int& operator*() const { return node->data; }
+        int* operator->() const { return &node->data; }
+
+        iterator& operator++() {
+            node = node->next;
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator previous = *this;
+            node = node->next;
+            return previous;
+        }
+
+        // Decrementing end() yields the last element, so end() remembers its list
+        iterator& operator--() {
+            node = node != nullptr ? node->prev : owner->tail;
+            return *this;
+        }
+
+        iterator operator--(int) {
+            iterator previous = *this;
+            --*this;
+            return previous;
+        }
+
+        bool operator==(const iterator& other) const { return node == other.node; }
+        bool operator!=(const iterator& other) const { return node != other.node; }
+
+    private:
+        friend class List;
+
+        Node* node = nullptr;
+        const List* owner = nullptr;
+
+        iterator(Node* n, const List* list) : node(n), owner(list) {}
+    };
 
+    List() : List(std::pmr::get_default_resource()) {}
+
+    // Takes its nodes, and the pool's own bookkeeping, from resource. A
+    // std::pmr::monotonic_buffer_resource that is released after each request
+    // frees a request's lists with a single pointer reset.
+    explicit List(std::pmr::memory_resource* resource)
+        : List(std::allocate_shared<NodePool>(std::pmr::polymorphic_allocator<NodePool>(resource), resource)) {}
+
+    // Lists that share a pool can splice nodes between each other
+    explicit List(std::shared_ptr<NodePool> sharedPool)
+        : head(nullptr), tail(nullptr), count(0), pool(std::move(sharedPool)) {}
+
+    // Nodes belong to this list, so a copy would share them
+    List(const List&) = delete;
+    List& operator=(const List&) = delete;
+
+    // Return every node to the pool, which may outlive this list
     ~List() {
+        clear();
+    }
+
+    const std::shared_ptr<NodePool>& sharedPool() const { return pool; }
+    std::size_t poolCapacity() const { return pool->capacity(); }
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    iterator begin() { return iterator(head, this); }
+    iterator end() { return iterator(nullptr, this); }
+
+    void clear() {
         while (head != nullptr) {
             Node* temp = head;
             head = head->next;
-            delete temp;
+            pool->release(temp);
         }
+        tail = nullptr;
+        count = 0;
     }
 
-    void insertAtBeginning(int data) {
-        Node* newNode = new Node(data);
-        if (head == nullptr) {
-            head = newNode;
-            tail = newNode;
-        } else {
-            newNode->next = head;
-            head->prev = newNode;
-            head = newNode;
+    iterator insertAtBeginning(int data) {
+        return insert(begin(), data);
+    }
+
+    iterator insertAtEnd(int data) {
+        return insert(end(), data);
+    }
+
+    // Function to insert before position in O(1) and return a handle to the new node
+    iterator insert(iterator position, int data) {
+        Node* newNode = pool->allocate(data);
+        attach(position.node, newNode, newNode);
+        ++count;
+        return iterator(newNode, this);
+    }
+
+    // Returns end() if the position is invalid
+    iterator insertAtPosition(int position, int data) {
+        if (position <= 0 || head == nullptr) {
+            std::cout << "Invalid position." << std::endl;
+            return end();
+        }
+
+        Node* current = head;
+        for (int i = 1; i < position - 1 && current != nullptr; ++i) {
+            current = current->next;
+        }
+
+        if (current == nullptr) {
+            std::cout << "Position out of bounds." << std::endl;
+            return end();
         }
+
+        return insert(position == 1 ? begin() : iterator(current->next, this), data);
     }
 
-    void insertAtEnd(int data) {
-        Node* newNode = new Node(data);
+    // Function to remove the node a handle refers to in O(1); returns the next position
+    iterator erase(iterator position) {
+        Node* node = position.node;
+        Node* next = node->next;
+        detach(node, node);
+        pool->release(node);
+        --count;
+        return iterator(next, this);
+    }
+
+    void deleteNode(int data) {
         if (head == nullptr) {
-            head = newNode;
-            tail = newNode;
-        } else {
-            newNode->prev = tail;
-            tail->next = newNode;
-            tail = newNode;
+            std::cout << "List is empty." << std::endl;
+            return;
+        }
+
+        for (iterator it = begin(); it != end(); ++it) {
+            if (*it == data) {
+                erase(it);
+                return;
+            }
         }
+        std::cout << "Data not found in the list." << std::endl;
     }
 
-    void insertAtPosition(int position, int data) {
-        if (position <= 0 || head == nullptr) {
-            std::cout << "Invalid position." << std::endl;
+    // Function to move [first, last) from other (which may be this list) to
+    // just before position without allocating. Relinking is O(1); moving
+    // between two different lists also walks the range to keep size() exact.
+    // The lists must share a pool, and position must not lie inside the range.
+    void splice(iterator position, List& other, iterator first, iterator last) {
+        if (first == last) {
             return;
         }
+        if (other.pool != pool) {
+            throw std::invalid_argument("splice needs lists that share a NodePool");
+        }
+        Node* lastNode = last.node != nullptr ? last.node->prev : other.tail;
+        if (&other != this) {
+            std::size_t moved = 1;
+            for (Node* node = first.node; node != lastNode; node = node->next) {
+                ++moved;
+            }
+            other.count -= moved;
+            count += moved;
+        }
+        other.detach(first.node, lastNode);
+        attach(position.node, first.node, lastNode);
+    }
+
+    // Function to move a single node, e.g. to the front of an LRU recency list
+    void splice(iterator position, List& other, iterator element) {
+        if (position == element || (&other == this && position.node == element.node->next)) {
+            return;
+        }
+        splice(position, other, element, iterator(element.node->next, &other));
+    }
+
+    // Function to move all of other's nodes before position in O(1)
+    void splice(iterator position, List& other) {
+        if (&other == this || other.empty()) {
+            return;
+        }
+        if (other.pool != pool) {
+            throw std::invalid_argument("splice needs lists that share a NodePool");
+        }
+        Node* first = other.head;
+        Node* last = other.tail;
+        count += other.count;
+        other.head = other.tail = nullptr;
+        other.count = 0;
+        attach(position.node, first, last);
+    }
 
-        Node* newNode = new Node(data);
+    void traverse() {
+        Node* current = head;
+        while (current != nullptr) {
+            std::cout << current->data << " -> ";
+            current = current->next;
+        }
+        std::cout << "nullptr" << std::endl;
+    }
 
-        if (position == 1) {
-            newNode->next = head;
-            head->prev = newNode;
-            head = newNode;
+private:
+    // Unlink the chain first..last (inclusive), fixing head and tail
+    void detach(Node* first, Node* last) {
+        if (first->prev != nullptr) {
+            first->prev->next = last->next;
         } else {
-            Node* current = head;
-            for (int i = 1; i < position - 1 && current != nullptr; ++i) {
-                current = current->next;
-            }
+            head = last->next;
+        }
+        if (last->next != nullptr) {
+            last->next->prev = first->prev;
+        } else {
+            tail = first->prev;
+        }
+        first->prev = nullptr;
+        last->next = nullptr;
+    }
 
-            if (current == nullptr) {
-                std::cout << "Position out of bounds." << std::endl;
-                delete newNode;
-                return;
-            }
+    // Link the chain first..last in front of position (nullptr means the end)
+    void attach(Node* position, Node* first, Node* last) {
+        Node* before = position != nullptr ? position->prev : tail;
+        first->prev = before;
+        last->next = position;
+        if (before != nullptr) {
+            before->next = first;
+        } else {
+            head = first;
+        }
+        if (position != nullptr) {
+            position->prev = last;
+        } else {
+            tail = last;
+        }
+    }
+};
 
-            newNode->next = current->next;
-            newNode->prev = current;
+//---------------------------------------------------------------------------
+// Intrusive list: the element itself carries the prev/next links
+//---------------------------------------------------------------------------
 
-            if (newNode->next != nullptr) {
-                newNode->next->prev = newNode;
-            } else {
-                tail = newNode;
-            }
+// Embed one ListHook per list an object can be on; the Tag tells the hooks
+// apart when an object sits on several lists at once.
+template <typename Tag = void>
+struct ListHook {
+    ListHook* prev = nullptr;
+    ListHook* next = nullptr;
+
+    bool linked() const { return next != nullptr; }
+};
+
+// A circular list around a sentinel hook. It never allocates and never owns
+// its elements: the caller keeps them alive while they are linked, and
+// removing an element is O(1) because the element knows its neighbours.
+template <typename T, typename Tag = void>
+class IntrusiveList {
+public:
+    using Hook = ListHook<Tag>;
+
+    IntrusiveList() { sentinel.prev = sentinel.next = &sentinel; }
+    IntrusiveList(const IntrusiveList&) = delete;
+    IntrusiveList& operator=(const IntrusiveList&) = delete;
+
+    ~IntrusiveList() {
+        while (!empty()) {
+            unlink(sentinel.next);
+        }
+    }
+
+    bool empty() const { return sentinel.next == &sentinel; }
+    std::size_t size() const { return count; }
+
+    T& front() { return element(sentinel.next); }
+    T& back() { return element(sentinel.prev); }
+
+    void pushFront(T& item) { linkBefore(sentinel.next, hook(item)); }
+    void pushBack(T& item) { linkBefore(&sentinel, hook(item)); }
+
+    void erase(T& item) { unlink(hook(item)); }
+
+    T& popFront() {
+        T& item = front();
+        unlink(sentinel.next);
+        return item;
+    }
+
+    template <typename Function>
+    void forEach(Function visit) {
+        for (Hook* node = sentinel.next; node != &sentinel; node = node->next) {
+            visit(element(node));
+        }
+    }
+
+private:
+    Hook sentinel;
+    std::size_t count = 0;
+
+    static Hook* hook(T& item) { return static_cast<Hook*>(&item); }
+    static T& element(Hook* node) { return *static_cast<T*>(node); }
+
+    void linkBefore(Hook* position, Hook* node) {
+        node->prev = position->prev;
+        node->next = position;
+        position->prev->next = node;
+        position->prev = node;
+        ++count;
+    }
+
+    void unlink(Hook* node) {
+        node->prev->next = node->next;
+        node->next->prev = node->prev;
+        node->prev = node->next = nullptr;
+        --count;
+    }
+};
+
+//---------------------------------------------------------------------------
+// Unrolled list: each node stores a cache line's worth of elements
+//---------------------------------------------------------------------------
+
+// Same operations as List, but every block holds up to Capacity ints (one
+// 64-byte cache line by default) plus one pair of links. Full blocks split in
+// half on insert, and blocks that drop below half full are merged with (or
+// refilled from) a neighbour on delete, so traversal touches roughly one
+// cache line per Capacity / 2 elements or better.
+template <std::size_t Capacity = 64 / sizeof(int)>
+class UnrolledList {
+    static_assert(Capacity >= 2, "A block must hold at least two elements");
+
+public:
+    UnrolledList() = default;
+    UnrolledList(const UnrolledList&) = delete;
+    UnrolledList& operator=(const UnrolledList&) = delete;
+
+    ~UnrolledList() {
+        while (head != nullptr) {
+            Block* temp = head;
+            head = head->next;
+            delete temp;
+        }
+    }
+
+    std::size_t size() const { return total; }
+    std::size_t blockCount() const { return blocks; }
+    static constexpr std::size_t blockBytes() { return sizeof(Block); }
+
+    void insertAtBeginning(int data) {
+        if (head == nullptr || head->count == Capacity) {
+            linkBlockBefore(head);
+        }
+        insertInto(head, 0, data);
+    }
+
+    void insertAtEnd(int data) {
+        if (tail == nullptr || tail->count == Capacity) {
+            linkBlockBefore(nullptr);
+        }
+        tail->items[tail->count++] = data;
+        ++total;
+    }
+
+    // Positions count from 1, as in List; skipping whole blocks makes the walk O(n / Capacity)
+    void insertAtPosition(int position, int data) {
+        if (position <= 0 || head == nullptr) {
+            std::cout << "Invalid position." << std::endl;
+            return;
+        }
+        std::size_t index = static_cast<std::size_t>(position) - 1;
+        if (index > total) {
+            std::cout << "Position out of bounds." << std::endl;
+            return;
+        }
+        if (index == total) {
+            insertAtEnd(data);
+            return;
+        }
 
-            current->next = newNode;
+        Block* block = head;
+        while (index > block->count) {
+            index -= block->count;
+            block = block->next;
         }
+        insertInto(block, index, data);
     }
 
     void deleteNode(int data) {
@@ -93,42 +507,473 @@ public:
             return;
         }
 
-        Node* current = head;
-        while (current != nullptr) {
-            if (current->data == data) {
-                if (current->prev == nullptr) {
-                    head = current->next;
-                    if (head != nullptr) {
-                        head->prev = nullptr;
-                    }
-                    delete current;
-                } else {
-                    current->prev->next = current->next;
-                    if (current->next != nullptr) {
-                        current->next->prev = current->prev;
-                    } else {
-                        tail = current->prev;
-                    }
-                    delete current;
+        for (Block* block = head; block != nullptr; block = block->next) {
+            for (std::size_t i = 0; i < block->count; ++i) {
+                if (block->items[i] == data) {
+                    std::copy(block->items + i + 1, block->items + block->count, block->items + i);
+                    --block->count;
+                    --total;
+                    rebalance(block);
+                    return;
                 }
-                return;
             }
-            current = current->next;
         }
         std::cout << "Data not found in the list." << std::endl;
     }
 
-    void traverse() {
-        Node* current = head;
-        while (current != nullptr) {
-            std::cout << current->data << " -> ";
-            current = current->next;
+    template <typename Function>
+    void forEach(Function visit) const {
+        for (const Block* block = head; block != nullptr; block = block->next) {
+            for (std::size_t i = 0; i < block->count; ++i) {
+                visit(block->items[i]);
+            }
         }
+    }
+
+    void traverse() const {
+        forEach([](int value) { std::cout << value << " -> "; });
         std::cout << "nullptr" << std::endl;
     }
+
+private:
+    struct Block {
+        Block* prev = nullptr;
+        Block* next = nullptr;
+        std::size_t count = 0;
+        int items[Capacity];
+    };
+
+    Block* head = nullptr;
+    Block* tail = nullptr;
+    std::size_t total = 0;
+    std::size_t blocks = 0;
+
+    // Link a new empty block in front of position (nullptr means the end)
+    Block* linkBlockBefore(Block* position) {
+        Block* block = new Block;
+        Block* before = position != nullptr ? position->prev : tail;
+        block->prev = before;
+        block->next = position;
+        if (before != nullptr) {
+            before->next = block;
+        } else {
+            head = block;
+        }
+        if (position != nullptr) {
+            position->prev = block;
+        } else {
+            tail = block;
+        }
+        ++blocks;
+        return block;
+    }
+
+    void unlinkBlock(Block* block) {
+        if (block->prev != nullptr) {
+            block->prev->next = block->next;
+        } else {
+            head = block->next;
+        }
+        if (block->next != nullptr) {
+            block->next->prev = block->prev;
+        } else {
+            tail = block->prev;
+        }
+        delete block;
+        --blocks;
+    }
+
+    void insertInto(Block* block, std::size_t offset, int data) {
+        if (block->count == Capacity) {
+            // Split: the upper half moves to a new block right after this one
+            Block* upper = linkBlockBefore(block->next);
+            constexpr std::size_t half = Capacity / 2;
+            std::copy(block->items + half, block->items + Capacity, upper->items);
+            upper->count = Capacity - half;
+            block->count = half;
+            if (offset > half) {
+                block = upper;
+                offset -= half;
+            }
+        }
+        std::copy_backward(block->items + offset, block->items + block->count, block->items + block->count + 1);
+        block->items[offset] = data;
+        ++block->count;
+        ++total;
+    }
+
+    // Restore the at-least-half-full rule after a delete
+    void rebalance(Block* block) {
+        constexpr std::size_t half = Capacity / 2;
+        if (block->count >= half) {
+            return;
+        }
+        if (block->count == 0) {
+            unlinkBlock(block);
+            return;
+        }
+
+        Block* next = block->next;
+        if (next != nullptr) {
+            if (block->count + next->count <= Capacity) {
+                std::copy(next->items, next->items + next->count, block->items + block->count);
+                block->count += next->count;
+                unlinkBlock(next);
+            } else {
+                // Borrow enough from the front of the next block to even them out
+                std::size_t moved = (next->count - block->count) / 2;
+                std::copy(next->items, next->items + moved, block->items + block->count);
+                std::copy(next->items + moved, next->items + next->count, next->items);
+                block->count += moved;
+                next->count -= moved;
+            }
+        } else if (block->prev != nullptr) {
+            Block* prev = block->prev;
+            if (prev->count + block->count <= Capacity) {
+                std::copy(block->items, block->items + block->count, prev->items + prev->count);
+                prev->count += block->count;
+                unlinkBlock(block);
+            } else {
+                // Borrow enough from the back of the previous block to even them out
+                std::size_t moved = (prev->count - block->count) / 2;
+                std::copy_backward(block->items, block->items + block->count, block->items + block->count + moved);
+                std::copy(prev->items + prev->count - moved, prev->items + prev->count, block->items);
+                block->count += moved;
+                prev->count -= moved;
+            }
+        }
+    }
 };
 
-int main() {
+//---------------------------------------------------------------------------
+// Benchmark: steady-state churn (push at the back, erase the oldest)
+//---------------------------------------------------------------------------
+
+struct CacheEntry : ListHook<> {
+    int key = 0;
+};
+
+template <typename Function>
+double timeMs(Function run) {
+    auto start = std::chrono::steady_clock::now();
+    run();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+// Every variant removes the values 0 .. operations - 1 in order
+void reportChurn(const char* name, double ms, long long removedSum, int operations) {
+    std::cout << name << ms << " ms";
+    if (removedSum != static_cast<long long>(operations) * (operations - 1) / 2) {
+        std::cout << "  [MISMATCH]";
+    }
+    std::cout << std::endl;
+}
+
+void benchmarkChurn(int operations, int liveNodes) {
+    std::cout << "\nChurn: " << operations << " push/erase pairs with " << liveNodes << " live nodes" << std::endl;
+
+    long long checksum = 0;
+    double stdMs = timeMs([&] {
+        std::list<int> list;
+        for (int i = 0; i < liveNodes; ++i) {
+            list.push_back(i);
+        }
+        for (int i = liveNodes; i < operations + liveNodes; ++i) {
+            list.push_back(i);
+            checksum += list.front();
+            list.pop_front();
+        }
+    });
+    reportChurn("std::list:     ", stdMs, checksum, operations);
+
+    checksum = 0;
+    std::size_t poolNodes = 0;
+    double pooledMs = timeMs([&] {
+        List list;
+        for (int i = 0; i < liveNodes; ++i) {
+            list.insertAtEnd(i);
+        }
+        for (int i = liveNodes; i < operations + liveNodes; ++i) {
+            list.insertAtEnd(i);
+            list.deleteNode(i - liveNodes); // the oldest value is always at the head
+            checksum += i - liveNodes;
+        }
+        poolNodes = list.poolCapacity();
+    });
+    reportChurn("List (pooled): ", pooledMs, checksum, operations);
+    std::cout << "  pool holds " << poolNodes << " nodes" << std::endl;
+
+    checksum = 0;
+    double intrusiveMs = timeMs([&] {
+        std::vector<CacheEntry> entries(static_cast<std::size_t>(liveNodes) + 1);
+        IntrusiveList<CacheEntry> list;
+        for (int i = 0; i < liveNodes; ++i) {
+            entries[i].key = i;
+            list.pushBack(entries[i]);
+        }
+        std::size_t spare = static_cast<std::size_t>(liveNodes);
+        for (int i = liveNodes; i < operations + liveNodes; ++i) {
+            entries[spare].key = i;
+            list.pushBack(entries[spare]);
+            CacheEntry& oldest = list.popFront();
+            checksum += oldest.key;
+            spare = static_cast<std::size_t>(&oldest - entries.data());
+        }
+    });
+    reportChurn("IntrusiveList: ", intrusiveMs, checksum, operations);
+}
+
+//---------------------------------------------------------------------------
+// Benchmark: LRU cache recency list (hit = move to front, miss = evict back)
+//---------------------------------------------------------------------------
+
+// Works with List and std::list alike: the map stores each key's iterator, so
+// a hit is one hash lookup plus an O(1) splice to the front.
+template <typename ListType>
+std::size_t lruWithHandles(const std::vector<int>& keys, std::size_t capacity) {
+    ListType recency;
+    std::unordered_map<int, typename ListType::iterator> index;
+    index.reserve(capacity * 2);
+    std::size_t hits = 0;
+
+    for (int key : keys) {
+        auto found = index.find(key);
+        if (found != index.end()) {
+            recency.splice(recency.begin(), recency, found->second);
+            ++hits;
+            continue;
+        }
+        if (recency.size() == capacity) {
+            auto oldest = std::prev(recency.end());
+            index.erase(*oldest);
+            recency.erase(oldest);
+        }
+        index.emplace(key, recency.insert(recency.begin(), key));
+    }
+    return hits;
+}
+
+// What the old List forced: find the key by value on every hit
+std::size_t lruWithValueSearch(const std::vector<int>& keys, std::size_t capacity) {
+    List recency;
+    std::unordered_map<int, bool> present;
+    std::size_t hits = 0;
+
+    for (int key : keys) {
+        if (present.count(key) != 0) {
+            recency.deleteNode(key);
+            recency.insertAtBeginning(key);
+            ++hits;
+            continue;
+        }
+        if (recency.size() == capacity) {
+            auto oldest = std::prev(recency.end());
+            present.erase(*oldest);
+            recency.erase(oldest);
+        }
+        present[key] = true;
+        recency.insertAtBeginning(key);
+    }
+    return hits;
+}
+
+void benchmarkLru(std::size_t operations, std::size_t capacity) {
+    // Every run starts by filling the cache with distinct keys (all misses),
+    // so the measured operations see a full cache
+    std::vector<int> keys(capacity);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> key(0, static_cast<int>(capacity * 2));
+    for (std::size_t i = 0; i < operations; ++i) {
+        keys.push_back(key(rng));
+    }
+    std::vector<int> fewKeys(keys.begin(), keys.begin() + static_cast<std::ptrdiff_t>(capacity + operations / 1000));
+
+    std::cout << "\nLRU recency list, capacity " << capacity << std::endl;
+    auto report = [](const char* name, std::size_t ops, double ms, std::size_t hits) {
+        std::cout << name << ops << " ops in " << ms << " ms, "
+                  << ops / (ms / 1000.0) / 1e6 << " Mops/s, " << hits << " hits" << std::endl;
+    };
+
+    std::size_t hits = 0;
+    double ms = timeMs([&] { hits = lruWithHandles<std::list<int>>(keys, capacity); });
+    report("std::list + handles:  ", operations, ms, hits);
+
+    ms = timeMs([&] { hits = lruWithHandles<List>(keys, capacity); });
+    report("List + handles:       ", operations, ms, hits);
+
+    ms = timeMs([&] { hits = lruWithValueSearch(fewKeys, capacity); });
+    report("List + value search:  ", operations / 1000, ms, hits);
+}
+
+//---------------------------------------------------------------------------
+// Benchmark: traversal and positional insert, List vs UnrolledList vs vector
+//---------------------------------------------------------------------------
+
+void benchmarkUnrolled(std::size_t elements) {
+    std::cout << "\n" << elements << " elements" << std::endl;
+    std::mt19937 rng(9);
+
+    std::vector<int> vector;
+    List list;
+    UnrolledList<> unrolled;
+    for (std::size_t i = 0; i < elements; ++i) {
+        vector.push_back(static_cast<int>(i));
+        list.insertAtEnd(static_cast<int>(i));
+        unrolled.insertAtEnd(static_cast<int>(i));
+    }
+
+    // A long-lived list's nodes end up scattered in memory. Splicing the nodes
+    // into a second list in random order reproduces that without allocating.
+    List scattered(list.sharedPool());
+    {
+        std::vector<List::iterator> nodes;
+        nodes.reserve(elements);
+        for (List::iterator it = list.begin(); it != list.end(); ++it) {
+            nodes.push_back(it);
+        }
+        std::shuffle(nodes.begin(), nodes.end(), rng);
+        for (List::iterator node : nodes) {
+            scattered.splice(scattered.end(), list, node);
+        }
+    }
+
+    const long long expected = static_cast<long long>(elements) * (elements - 1) / 2;
+    auto report = [&](const char* name, double ms, long long sum, double bytesPerElement) {
+        std::cout << "  traverse " << name << ms << " ms, "
+                  << bytesPerElement << " bytes/element" << (sum == expected ? "" : "  [MISMATCH]") << std::endl;
+    };
+
+    long long sum = 0;
+    double ms = timeMs([&] { sum = std::accumulate(vector.begin(), vector.end(), 0LL); });
+    report("std::vector:       ", ms, sum, static_cast<double>(vector.capacity() * sizeof(int)) / elements);
+
+    sum = 0;
+    ms = timeMs([&] { unrolled.forEach([&sum](int value) { sum += value; }); });
+    report("UnrolledList:      ", ms, sum, static_cast<double>(unrolled.blockCount() * unrolled.blockBytes()) / elements);
+
+    sum = 0;
+    ms = timeMs([&] { sum = std::accumulate(scattered.begin(), scattered.end(), 0LL); });
+    report("List (scattered):  ", ms, sum, static_cast<double>(sizeof(Node)));
+
+    // Positional inserts are O(n) for all three; what differs is the constant.
+    // The scattered List misses the cache on every step, so it gets fewer.
+    const int inserts = 200;
+    const int listInserts = 5;
+    std::uniform_int_distribution<int> position(1, static_cast<int>(elements));
+    std::vector<int> positions(inserts);
+    for (int& p : positions) {
+        p = position(rng);
+    }
+    auto reportInsert = [&](const char* name, double ms, int count) {
+        std::cout << "  insertAtPosition " << name << ms * 1000.0 / count << " us/insert" << std::endl;
+    };
+
+    reportInsert("std::vector:  ", timeMs([&] {
+        for (int p : positions) {
+            vector.insert(vector.begin() + (p - 1), -1);
+        }
+    }), inserts);
+    reportInsert("UnrolledList: ", timeMs([&] {
+        for (int p : positions) {
+            unrolled.insertAtPosition(p, -1);
+        }
+    }), inserts);
+    reportInsert("List:         ", timeMs([&] {
+        for (int i = 0; i < listInserts; ++i) {
+            scattered.insertAtPosition(positions[i], -1);
+        }
+    }), listInserts);
+}
+
+//---------------------------------------------------------------------------
+// Benchmark: per-request lists on the global heap vs. a request arena
+//---------------------------------------------------------------------------
+
+// Passes every call on to upstream and counts the allocations
+class CountingResource : public std::pmr::memory_resource {
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream) : upstream(upstream) {}
+
+    std::size_t allocations = 0;
+
+private:
+    std::pmr::memory_resource* upstream;
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        return upstream->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        upstream->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+// A request builds a few short lists (a queue of pending items, say), drops
+// every third item by handle and adds up the rest
+long long handleRequest(std::pmr::memory_resource* resource, int request) {
+    long long sum = 0;
+    for (int queue = 0; queue < 4; ++queue) {
+        List items(resource);
+        std::vector<List::iterator> dropped;
+        for (int i = 0; i < 100; ++i) {
+            List::iterator item = items.insertAtEnd(request + i);
+            if (i % 3 == 0) {
+                dropped.push_back(item);
+            }
+        }
+        for (List::iterator item : dropped) {
+            items.erase(item);
+        }
+        for (int value : items) {
+            sum += value;
+        }
+    }
+    return sum;
+}
+
+// The arena is a std::pmr::monotonic_buffer_resource over a buffer that every
+// request reuses. Allocating bumps a pointer, deallocating does nothing, and
+// release() after the request makes the whole buffer available again. The
+// difference to the heap run is the time spent in malloc and free.
+void benchmarkRequests(int requests) {
+    std::cout << "\nPer-request lists: " << requests << " requests" << std::endl;
+    CountingResource heap(std::pmr::new_delete_resource());
+    long long expected = 0;
+    double heapMs = timeMs([&] {
+        for (int request = 0; request < requests; ++request) {
+            expected += handleRequest(&heap, request);
+        }
+    });
+
+    CountingResource upstream(std::pmr::new_delete_resource());
+    std::vector<std::byte> buffer(64 * 1024);
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), &upstream);
+    long long sum = 0;
+    double arenaMs = timeMs([&] {
+        for (int request = 0; request < requests; ++request) {
+            sum += handleRequest(&arena, request);
+            arena.release();
+        }
+    });
+
+    std::cout << "global heap:     " << heapMs * 1000.0 / requests << " us/request, "
+              << static_cast<double>(heap.allocations) / requests << " allocations/request" << std::endl;
+    std::cout << "request arena:   " << arenaMs * 1000.0 / requests << " us/request, "
+              << static_cast<double>(upstream.allocations) / requests << " allocations/request";
+    if (sum != expected) {
+        std::cout << "  [MISMATCH]";
+    }
+    std::cout << std::endl;
+    std::cout << "allocator share: " << 100.0 * (heapMs - arenaMs) / heapMs << "% of the heap version's time"
+              << std::endl;
+}
+
+int main(int argc, char* argv[]) {
     List list;
 
     list.insertAtBeginning(3);
@@ -148,69 +993,147 @@ int main() {
 
     list.traverse();
 
+    CacheEntry a, b, c;
+    a.key = 1;
+    b.key = 2;
+    c.key = 3;
+    IntrusiveList<CacheEntry> recency;
+    recency.pushBack(a);
+    recency.pushBack(b);
+    recency.pushBack(c);
+    recency.erase(b);
+    recency.pushBack(b); // b was used again, so it moves to the back
+    std::cout << "Intrusive recency order:";
+    recency.forEach([](CacheEntry& entry) { std::cout << " " << entry.key; });
+    std::cout << std::endl;
+
+    // Handles: erase in O(1), walk backwards, splice between lists
+    List first;
+    List second(first.sharedPool());
+    List::iterator seven = first.insertAtEnd(7);
+    first.insertAtEnd(8);
+    first.insertAtEnd(9);
+    second.insertAtEnd(1);
+    second.insertAtEnd(2);
+
+    second.splice(second.end(), first, seven, first.end());
+    std::cout << "After splicing 7..9 into second: ";
+    second.traverse();
+
+    second.erase(seven);
+    std::cout << "Backwards after erasing 7 by handle:";
+    for (List::iterator it = second.end(); it != second.begin();) {
+        std::cout << " " << *--it;
+    }
+    std::cout << std::endl;
+
+    UnrolledList<4> small;
+    for (int i = 1; i <= 10; ++i) {
+        small.insertAtEnd(i);
+    }
+    small.insertAtPosition(3, 42);
+    small.deleteNode(1);
+    small.deleteNode(2);
+    std::cout << "Unrolled list in " << small.blockCount() << " blocks: ";
+    small.traverse();
+
+    int operations = argc > 1 ? std::atoi(argv[1]) : 10000000;
+    benchmarkChurn(operations, 1000);
+    benchmarkLru(static_cast<std::size_t>(operations), 100000);
+    benchmarkRequests(std::max(operations / 100, 1));
+
+    std::size_t largest = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000000;
+    for (std::size_t elements = 1000000; elements <= largest; elements *= 10) {
+        benchmarkUnrolled(elements);
+    }
+
     return 0;
 }
 ```
 
-This `List.cpp` defines a doubly-linked list with the required functionalities. The main function demonstrates different scenarios for inserting, deleting, and traversing the list.
+This `List.cpp` defines a doubly-linked list that takes its nodes from a memory pool and hands out iterators that work as handles, plus an intrusive list where the elements carry the links themselves and an unrolled list that stores several values per node. The main function demonstrates inserting, deleting, splicing and traversing these lists, and then measures node churn, an LRU cache workload compared with `std::list`, per-request lists on the global heap and in an arena, and traversal of very long lists compared with `std::vector`.
 
-This C++ code matters because it provides an implementation of a doubly-linked list, which is a data structure that allows for efficient insertion and deletion of elements at any position within the list, as well as traversal of the list in both directions.
+This C++ code matters because linked lists are often used for bookkeeping that changes constantly, such as the recency order of an LRU cache. In that situation every insert calls `new` and every delete calls `delete`, and the memory allocator can end up using more time than the list itself. The code shows two ways around this:
 
-The `List` class defines a doubly-linked list with a `head` and a `tail` pointer, which point to the first and last nodes in the list, respectively. Each node in the list has three pointers: `data`, `next`, and `prev`. `data` stores the value of the node, `next` points to the next node in the list, and `prev` points to the previous node in the list.
+1. **Pooling**: The list takes its nodes from a `NodePool`. Deleted nodes go on a free list and are handed out again by the next insert, so once the list has reached its working size, no more allocator calls are made.
+
+2. **Handles**: Every insert returns an iterator to the new node. Keeping that iterator (for example in a hash map) lets the caller erase or move the node later in O(1), instead of searching the list for its value.
+
+3. **Intrusive linking**: The object that is stored on the list embeds the `prev` and `next` pointers itself (by inheriting from `ListHook`). Nothing is allocated when it is linked or unlinked, and it can be removed in O(1) because it knows its own neighbours.
+
+4. **Unrolling**: When the list is mostly walked from one end to the other, one value per node is the problem. Every step is a pointer chase to a node that may be anywhere in memory. `UnrolledList` packs up to `Capacity` values into each block, so a walk touches one block per cache line instead of one node per value.
+
+5. **Arenas**: A pool only helps a list that lives long enough to reuse its nodes. Lists that are built during one request and thrown away at its end can take their memory from a `std::pmr::memory_resource` instead, such as a monotonic arena that is reset once per request.
 
 The `List` class includes the following functions:
 
-1. `List()`: Constructor that initializes the list with an empty head and tail.
-2. `~List()`: Destructor that deletes all nodes in the list.
-3. `insertAtBeginning(int data)`: Inserts a new node with the given data value at the beginning of the list.
-4. `insertAtEnd(int data)`: Inserts a new node with the given data value at the end of the list.
-5. `insertAtPosition(int position, int data)`: Inserts a new node with the given data value at the specified position in the list.
-6. `deleteNode(int data)`: Deletes the first node in the list with the given data value.
-7. `traverse()`: Traverses the list and prints out the data values of each node in order.
+1. `List()`: Constructor that initializes an empty list with its own pool. `List(std::pmr::memory_resource*)` does the same but takes the pool and its nodes from the given memory resource, and `List(std::shared_ptr<NodePool>)` creates a list that shares another list's pool.
+2. `~List()`: The destructor returns every node to the pool, which may still be in use by other lists.
+3. `insertAtBeginning(int data)`, `insertAtEnd(int data)`: Insert a new node at either end and return an iterator to it.
+4. `insert(iterator position, int data)`: Inserts a new node before `position` in O(1) and returns an iterator to it.
+5. `insertAtPosition(int position, int data)`: Inserts a new node at the specified position in the list, counting from 1. It walks to the position, so it is O(n), and returns `end()` if the position is invalid.
+6. `erase(iterator position)`: Removes the node in O(1) and returns an iterator to the node after it.
+7. `deleteNode(int data)`: Deletes the first node in the list with the given data value. It has to search, so it is O(n).
+8. `splice(...)`: Moves a single node, a range `[first, last)`, or a whole list to just before `position`, without allocating or copying any values.
+9. `begin()`, `end()`, `size()`, `empty()`, `clear()` and `traverse()`: Iteration, bookkeeping and printing.
+10. `poolCapacity()`: Reports how many nodes the pool has obtained from the allocator so far.
+
+Here is a breakdown of the concepts used in the code:
+
+1. `NodePool`: Allocates nodes in chunks from a `std::pmr::memory_resource` (the global heap by default), starting at 16 nodes and doubling up to 4096. The nodes of a new chunk are threaded onto the free list in address order, so nodes inserted one after another end up next to each other in memory, which makes traversal friendlier to the cache. `allocate` pops a node from the free list and `release` pushes it back, both in O(1). The list of chunks is a `std::pmr::vector` on the same resource, and the destructor gives every chunk back to it.
+
+2. `std::shared_ptr<NodePool>`: A node can only move to another list if both lists take nodes from the same pool, because the pool owns the memory. Sharing the pool through a `shared_ptr` keeps it alive until the last list that uses it is gone. `splice` throws `std::invalid_argument` when the pools differ.
+
+3. `List::iterator`: A bidirectional iterator with the usual member types (`iterator_category`, `value_type`, and so on), so it works with standard algorithms such as `std::prev` and `std::advance`. It stores the node and the list it belongs to; the list is needed so that `--end()` can step back to the tail.
+
+4. `detach` and `attach`: Two private helpers that unlink a chain of nodes and link it in front of another node. Every insert, erase and splice is written in terms of them, so the head and tail bookkeeping lives in one place.
+
+5. Splice and `size()`: Moving a range between two different lists has to count the nodes to keep `size()` correct, so that case is O(length of the range). Moving a single node, moving nodes within one list, and moving a whole list are all O(1). `std::list` makes the same trade-off.
+
+6. Deleted copy operations: A `List` cannot be copied, because the copy would point at the same nodes. Writing `List(const List&) = delete;` turns an accidental copy into a compile error instead of a crash.
+
+7. `ListHook<Tag>`: A small struct with `prev` and `next` pointers. A type that wants to be stored on an intrusive list inherits from it, for example `struct CacheEntry : ListHook<> { int key; };`. The `Tag` parameter lets an object inherit several hooks and sit on several lists at once.
+
+8. `IntrusiveList<T, Tag>`: A circular list built around a `sentinel` hook. Because the sentinel is always there, linking and unlinking never have to check for `nullptr` heads or tails. `static_cast` converts between a `T` and its hook. The list never owns its elements; the caller must keep them alive while they are linked.
+
+9. Intrusive list functions: `pushFront`, `pushBack`, `popFront`, `front`, `back`, `erase`, `forEach`, `size` and `empty`. `erase(item)` is O(1) because the item's hook already points at its neighbours.
+
+10. The churn benchmark: A list holds 1000 live entries; each step appends a new value and removes the oldest. `std::list` allocates and frees a node on every step, the pooled `List` reuses the same 1000-odd nodes, and the intrusive list moves entries of a preallocated `std::vector` around. The number of steps can be passed as the first command line argument.
 
-The `main` function demonstrates the use of the `List` class by creating an empty list, inserting several nodes at various positions, deleting nodes with specific data values, and traversing the list to print out the data values.
+11. The LRU benchmark: `lruWithHandles` keeps the keys of a 100,000-entry cache in recency order and stores each key's iterator in a `std::unordered_map`. A hit splices the node to the front, a miss evicts the last node. It is a template, so the same code runs with `List` and with `std::list`. `lruWithValueSearch` shows what the old interface forced: `deleteNode` plus a new insert on every hit. It is run on a thousand times fewer operations because each hit walks a long part of the list.
 
-Overall, this code implementation is important because it provides a straightforward and efficient way to manage and manipulate dynamic lists in C++ programs. The doubly-linked list structure allows for efficient insertion, deletion, and traversal, making it a useful data structure for a wide range of applications.
+12. `UnrolledList<Capacity>`: A doubly-linked list of `Block`s, each holding a `prev` and `next` pointer, a `count`, and an array of up to `Capacity` values. By default `Capacity` is `64 / sizeof(int)`, so the values of a block fill one 64-byte cache line; `blockBytes()` reports the full block size including the links and count. It has the same `insertAtBeginning`, `insertAtEnd`, `insertAtPosition`, `deleteNode` and `traverse` functions as `List`, plus `forEach` and `blockCount`.
 
-In this C++ code, we have a doubly-linked list implementation with a `Node` class and a `List` class. The `Node` class represents a single node in the list and has three important members: `data`, `next`, and `prev`.
+13. Splitting: When a value has to go into a full block, the upper half of the block moves to a new block linked right after it, and the value goes into whichever half it belongs to. A full tail block is not split; `insertAtEnd` starts a new block instead, so a list built by appending keeps its blocks full.
 
-1. `data`: The data stored in the current node.
-2. `next`: A pointer to the next node in the list.
-3. `prev`: A pointer to the previous node in the list.
+14. Rebalancing: After `deleteNode` removes a value, a block that has dropped below half full either merges with its next block (if everything fits) or borrows values from the front of it. The last block does the same with the previous one: it merges into it, or takes values from its back. This keeps the average block at least half full, so the walk in `insertAtPosition` stays O(n / Capacity).
 
-The constructor for the `Node` class initializes the data member with the given argument and sets both `next` and `prev` pointers to `nullptr`.
+15. The long list benchmark: Builds the same sequence in a `std::vector`, an `UnrolledList`, and a `List` whose nodes have been shuffled with `splice`, the way a long-lived list ends up after many inserts and deletes. It reports the time for a full traversal, the memory used per element, and the cost of inserting at random positions. The largest list size can be passed as the second command line argument; the benchmark starts at one million elements and multiplies by ten up to that size, so `100000000` runs it at 100 million too (this needs a few gigabytes of memory).
 
-The `List` class is defined to manage and handle the `Node` objects. It has two private members: `head` and `tail`.
+16. The request benchmark: `handleRequest` builds four lists of 100 values, erases every third value by handle and adds up the rest. `benchmarkRequests` runs it with lists on the global heap and with lists in a `std::pmr::monotonic_buffer_resource`. The arena's 64 KB buffer is reused by every request and `release()` resets it after each one. A `CountingResource` wrapped around the heap counts the calls that reach `malloc`. Since the pool already reuses nodes within a list, only the chunks and the pools themselves are saved, about 28 allocations per request.
 
-1. `head`: A pointer to the first node in the list.
-2. `tail`: A pointer to the last node in the list.
+As a beginner, you might commit some common mistakes with code like this. Here are a few possible errors to look out for:
 
-The `List` class provides the following public functions:
+1. **Deleting pooled nodes**: A node that came from the pool must go back with `pool.release(node)`. Calling `delete` on it is undefined behavior, because it was never allocated on its own.
 
-1. `List()`: The constructor initializes both `head` and `tail` to `nullptr`.
-2. `~List()`: The destructor deallocates the memory for all Nodes in the list by iterating through the list and deleting each node.
-3. `void insertAtBeginning(int data)`: This member function inserts a new node containing the provided `data` at the beginning of the list. If the list is empty, both the new head and tail will be the same node.
-4. `void insertAtEnd(int data)`: This member function inserts a new node containing the provided `data` at the end of the list. If the list is empty, both the new head and tail will be the same node.
-5. `void insertAtPosition(int position, int data)`: This member function inserts a new node containing the provided `data` at the specified position in the list. If the position is invalid, it will print an error message and return.
-6. `void deleteNode(int data)`: This member function deletes the first occurrence of a node containing the provided `data` in the list. If the data is not found in the list, it prints an error message.
-7. `void traverse()`: This member function prints all the data of the nodes in the list in a linear fashion from the head to the tail.
+2. **Copying a list that owns a pool**: The default copy constructor would copy the `head` and `tail` pointers, and both lists would then share and free the same nodes. Delete or implement the copy operations.
 
-In the main function, we create an instance of the `List` class and demonstrate inserting, deleting, and traversing the list with various scenarios.
+3. **Destroying an object while it is still linked**: An intrusive list only stores pointers into your objects. If an object is destroyed while it is still on the list, its neighbours point at freed memory. Remove it first (or make sure the list is destroyed before the objects).
 
-This C++ code for a doubly-linked list is quite well-structured and follows good practices. However, as a beginner, you might commit some common mistakes. Here are a few possible errors to look out for:
+4. **Using a handle after erasing its node**: An iterator stays valid through any other insert, erase or splice, but not after its own node is erased. The LRU code removes the key from the map before it erases the node.
 
-1. **Memory Management**: Ensure you're correctly allocating and deallocating memory. In your code, you're doing this properly by using `new` for allocation and `delete` for deallocation in the `Node` and `List` classes.
+5. **Splicing a range into itself**: `position` must not point inside the range being moved, or the list ends up with a cycle. `std::list::splice` has the same rule.
 
-2. **Integer Overflow/Underflow**: Be careful with arithmetic operations involving integer data types. For example, if you're implementing `insertAtPosition` and the position is out of the list's bounds. In your code, you've handled this case by checking for valid positions.
+6. **Allocating before validating**: In `insertAtPosition`, checking the position before taking a node avoids having to give the node back on the error path.
 
-3. **Null Pointers**: Check for null pointers before performing operations. For instance, in `deleteNode` function, if the current node is null, it means the data is not found in the list, and you should print an appropriate message.
+7. **Forgetting to update both ends**: When deleting the head or tail, both `head`/`tail` and the neighbour's `prev`/`next` must be updated. Keeping this logic in one place, as `detach` and `attach` do, makes it easy to check.
 
-4. **Off-by-one Errors**: This can be a common mistake when dealing with arrays, indices, or loops with conditions. In your code, you seem to have properly handled any potential off-by-one errors.
+8. **Measuring allocation costs with tiny inputs**: The allocator only shows up in profiles when millions of nodes are churned. Benchmark with realistic operation counts, as the churn benchmark does.
 
-5. **Boundary Conditions**: Ensure all functions work correctly if the list is empty or has only one item. In your code, you handle these conditions adequately.
+9. **Benchmarking a freshly built list**: Nodes allocated one after another sit next to each other in memory, so a new `List` traverses almost as fast as an array. Real lists get scattered over time, which is why the benchmark shuffles the nodes first.
 
-6. **Use of uninitialized variables**: Make sure variables such as `head` and `tail` in the `List` constructor are initialized to null.
+10. **Splitting on every append**: If a full tail block were split in half, a list built with `insertAtEnd` would end up with half-empty blocks and twice the memory. Start a new block at the end instead.
 
-7. **Consistency in Naming Conventions**: Be consistent with your naming conventions. For example, use names like `insertAtBeginning`, `insertAtEnd`, and `insertAtPosition` instead of `insertFirst`, `insertLast`, and `append`.
+11. **Forgetting to rebalance after deletes**: Without merging, deleting values can leave many nearly empty blocks, and the unrolled list slowly turns back into an ordinary linked list.
 
-8. **Code Readability and Maintenance**: Ensure the code is well-structured and easy to read. Separate concerns into different functions, properly indent code, and include enough comments to explain complex algorithms.
\ No newline at end of file
+12. **Using arena memory after the reset**: `release()` makes the arena hand out the same memory again. A list built in it, or a `NodePool` shared from it, must be destroyed before the reset.
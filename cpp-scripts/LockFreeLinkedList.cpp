@@ -0,0 +1,619 @@
+```cpp
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+
+//---------------------------------------------------------------------------
+// Baseline: the singly linked list from LinkedList.cpp behind one mutex
+//---------------------------------------------------------------------------
+
+// Compact copy of LinkedList (tail pointer, cached size, node blocks) with
+// the pop_front that a work queue needs
+class LinkedList {
+public:
+    struct Node {
+        int data = 0;
+        Node* next = nullptr;
+    };
+
+    LinkedList() = default;
+    LinkedList(const LinkedList&) = delete;
+    LinkedList& operator=(const LinkedList&) = delete;
+
+    std::size_t size() const { return count; }
+
+    void push_back(int d) {
+        Node* newNode = allocate(d);
+        if (tail == nullptr) {
+            head = newNode;
+        } else {
+            tail->next = newNode;
+        }
+        tail = newNode;
+        ++count;
+    }
+
+    void push_front(int d) {
+        Node* newNode = allocate(d);
+        newNode->next = head;
+        head = newNode;
+        if (tail == nullptr) {
+            tail = newNode;
+        }
+        ++count;
+    }
+
+    bool pop_front(int& out) {
+        if (head == nullptr) {
+            return false;
+        }
+        Node* temp = head;
+        head = head->next;
+        if (head == nullptr) {
+            tail = nullptr;
+        }
+        out = temp->data;
+        temp->next = spare;
+        spare = temp;
+        --count;
+        return true;
+    }
+
+private:
+    Node* head = nullptr;
+    Node* tail = nullptr;
+    Node* spare = nullptr;
+    std::size_t count = 0;
+    std::vector<std::unique_ptr<Node[]>> blocks;
+
+    Node* allocate(int d) {
+        if (spare == nullptr) {
+            const std::size_t n = 4096;
+            blocks.push_back(std::make_unique<Node[]>(n));
+            for (std::size_t i = n; i-- > 0;) {
+                blocks.back()[i].next = spare;
+                spare = &blocks.back()[i];
+            }
+        }
+        Node* node = spare;
+        spare = spare->next;
+        node->data = d;
+        node->next = nullptr;
+        return node;
+    }
+};
+
+// How work items are passed between threads today: every operation takes the lock
+class LockedStack {
+public:
+    void push(int value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        list.push_front(value);
+    }
+
+    bool tryPop(int& out) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return list.pop_front(out);
+    }
+
+private:
+    std::mutex mutex;
+    LinkedList list;
+};
+
+class LockedQueue {
+public:
+    void push(int value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        list.push_back(value);
+    }
+
+    bool tryPop(int& out) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return list.pop_front(out);
+    }
+
+private:
+    std::mutex mutex;
+    LinkedList list;
+};
+
+//---------------------------------------------------------------------------
+// Hazard pointers: safe memory reclamation for lock-free containers
+//---------------------------------------------------------------------------
+
+// A thread that is about to read a node publishes the node's address in one
+// of its hazard slots. A removed node is not deleted right away but retired;
+// it is only freed once no hazard slot points at it. That also rules out the
+// ABA problem: a node cannot be freed and reused at the same address while
+// somebody still holds its old address for a compare-and-swap.
+class HazardPointers {
+public:
+    static constexpr std::size_t maxThreads = 128;
+    static constexpr std::size_t slotsPerThread = 2;
+
+    static HazardPointers& instance() {
+        static HazardPointers domain;
+        return domain;
+    }
+
+    ~HazardPointers() {
+        for (Retired& item : orphans) {
+            item.destroy(item.pointer);
+        }
+    }
+
+    // Function to publish the current value of source in a slot. The value is
+    // re-read after publishing, so it cannot have been retired in between.
+    template <typename T>
+    T* protect(std::size_t slot, const std::atomic<T*>& source) {
+        std::atomic<void*>& hazard = local().record->slots[slot];
+        T* pointer = source.load();
+        while (true) {
+            hazard.store(pointer);
+            T* again = source.load();
+            if (again == pointer) {
+                return pointer;
+            }
+            pointer = again;
+        }
+    }
+
+    // Publish a pointer that the caller validates on its own
+    void set(std::size_t slot, void* pointer) {
+        local().record->slots[slot].store(pointer);
+    }
+
+    void clear(std::size_t slot) {
+        local().record->slots[slot].store(nullptr, std::memory_order_release);
+    }
+
+    // Function to hand over a removed node; it is deleted once nobody protects it
+    template <typename T>
+    void retire(T* pointer) {
+        ThreadState& state = local();
+        state.retired.push_back({pointer, [](void* p) { delete static_cast<T*>(p); }});
+        if (state.retired.size() >= 2 * maxThreads * slotsPerThread) {
+            scan(state.retired);
+        }
+    }
+
+private:
+    struct Retired {
+        void* pointer;
+        void (*destroy)(void*);
+    };
+
+    struct alignas(64) Record {
+        std::atomic<bool> active{false};
+        std::atomic<void*> slots[slotsPerThread] = {};
+    };
+
+    // Claims a record on first use and gives it back when the thread exits
+    struct ThreadState {
+        Record* record = nullptr;
+        std::vector<Retired> retired;
+
+        ~ThreadState() {
+            HazardPointers& domain = instance();
+            domain.scan(retired);
+            {
+                std::lock_guard<std::mutex> lock(domain.orphanMutex);
+                domain.orphans.insert(domain.orphans.end(), retired.begin(), retired.end());
+            }
+            for (auto& slot : record->slots) {
+                slot.store(nullptr);
+            }
+            record->active.store(false, std::memory_order_release);
+        }
+    };
+
+    Record records[maxThreads];
+    std::mutex orphanMutex;
+    std::vector<Retired> orphans; // left behind by threads that exited
+
+    ThreadState& local() {
+        thread_local ThreadState state;
+        if (state.record == nullptr) {
+            for (Record& record : records) {
+                bool expected = false;
+                if (!record.active.load(std::memory_order_relaxed) &&
+                    record.active.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                    state.record = &record;
+                    break;
+                }
+            }
+            if (state.record == nullptr) {
+                std::cerr << "More than " << maxThreads << " threads use hazard pointers" << std::endl;
+                std::abort();
+            }
+        }
+        return state;
+    }
+
+    // Free every retired node that no thread has published
+    void scan(std::vector<Retired>& retired) {
+        {
+            std::unique_lock<std::mutex> lock(orphanMutex, std::try_to_lock);
+            if (lock.owns_lock() && !orphans.empty()) {
+                retired.insert(retired.end(), orphans.begin(), orphans.end());
+                orphans.clear();
+            }
+        }
+
+        std::vector<void*> hazards;
+        for (Record& record : records) {
+            for (auto& slot : record.slots) {
+                if (void* pointer = slot.load()) {
+                    hazards.push_back(pointer);
+                }
+            }
+        }
+        std::sort(hazards.begin(), hazards.end());
+
+        auto kept = std::partition(retired.begin(), retired.end(), [&](const Retired& item) {
+            return std::binary_search(hazards.begin(), hazards.end(), item.pointer);
+        });
+        for (auto it = kept; it != retired.end(); ++it) {
+            it->destroy(it->pointer);
+        }
+        retired.erase(kept, retired.end());
+    }
+};
+
+//---------------------------------------------------------------------------
+// Treiber stack
+//---------------------------------------------------------------------------
+
+// A singly linked list whose head is swapped with compare-and-swap. push
+// links the new node in front of the head it saw; tryPop moves the head to
+// head->next. If another thread changed the head in between, the CAS fails
+// and the operation retries with the new head.
+template <typename T>
+class LockFreeStack {
+public:
+    LockFreeStack() = default;
+    LockFreeStack(const LockFreeStack&) = delete;
+    LockFreeStack& operator=(const LockFreeStack&) = delete;
+
+    ~LockFreeStack() {
+        Node* node = head.load();
+        while (node != nullptr) {
+            Node* next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+
+    void push(T value) {
+        Node* node = new Node{std::move(value), head.load(std::memory_order_relaxed)};
+        while (!head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    bool tryPop(T& out) {
+        HazardPointers& hazards = HazardPointers::instance();
+        Node* node;
+        while (true) {
+            node = hazards.protect(0, head);
+            if (node == nullptr) {
+                hazards.clear(0);
+                return false;
+            }
+            // node is protected, so node->next is safe to read, and node
+            // cannot have been recycled: if head still equals node, the
+            // stack below it is unchanged
+            if (head.compare_exchange_weak(node, node->next, std::memory_order_acquire, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        hazards.clear(0);
+        out = std::move(node->data);
+        hazards.retire(node);
+        return true;
+    }
+
+private:
+    struct Node {
+        T data;
+        Node* next; // written before the node is published, never changed after
+    };
+
+    alignas(64) std::atomic<Node*> head{nullptr};
+};
+
+//---------------------------------------------------------------------------
+// Michael-Scott queue
+//---------------------------------------------------------------------------
+
+// A singly linked list with a dummy node at the front. head points at the
+// dummy, so the first real item is head->next; tail points at the last node
+// or, briefly, at the one before it. Any thread that finds tail lagging
+// moves it forward, so a stalled enqueuer never blocks the others.
+template <typename T>
+class LockFreeQueue {
+public:
+    LockFreeQueue() {
+        Node* dummy = new Node();
+        head.store(dummy);
+        tail.store(dummy);
+    }
+
+    LockFreeQueue(const LockFreeQueue&) = delete;
+    LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+    ~LockFreeQueue() {
+        Node* node = head.load();
+        while (node != nullptr) {
+            Node* next = node->next.load();
+            delete node;
+            node = next;
+        }
+    }
+
+    void push(T value) {
+        Node* node = new Node();
+        node->data = std::move(value);
+        HazardPointers& hazards = HazardPointers::instance();
+        while (true) {
+            Node* last = hazards.protect(0, tail);
+            Node* next = last->next.load(std::memory_order_acquire);
+            if (last != tail.load(std::memory_order_acquire)) {
+                continue;
+            }
+            if (next != nullptr) {
+                // tail is lagging behind: help the other enqueuer finish
+                tail.compare_exchange_weak(last, next, std::memory_order_release, std::memory_order_relaxed);
+                continue;
+            }
+            if (last->next.compare_exchange_weak(next, node, std::memory_order_release, std::memory_order_relaxed)) {
+                tail.compare_exchange_strong(last, node, std::memory_order_release, std::memory_order_relaxed);
+                break;
+            }
+        }
+        hazards.clear(0);
+    }
+
+    bool tryPop(T& out) {
+        HazardPointers& hazards = HazardPointers::instance();
+        while (true) {
+            Node* first = hazards.protect(0, head);
+            Node* last = tail.load(std::memory_order_acquire);
+            Node* next = first->next.load(std::memory_order_acquire);
+            hazards.set(1, next);
+            // If head has not moved, next was still reachable when it was
+            // published, so it cannot have been retired
+            if (first != head.load()) {
+                continue;
+            }
+            if (next == nullptr) {
+                hazards.clear(0);
+                hazards.clear(1);
+                return false;
+            }
+            if (first == last) {
+                tail.compare_exchange_weak(last, next, std::memory_order_release, std::memory_order_relaxed);
+                continue;
+            }
+            if (head.compare_exchange_weak(first, next, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                // next is the new dummy; only the winner of the CAS reads its data
+                out = std::move(next->data);
+                hazards.clear(0);
+                hazards.clear(1);
+                hazards.retire(first);
+                return true;
+            }
+        }
+    }
+
+private:
+    struct Node {
+        T data{};
+        std::atomic<Node*> next{nullptr};
+    };
+
+    // Separate cache lines, so enqueuers and dequeuers do not contend on one
+    alignas(64) std::atomic<Node*> head;
+    alignas(64) std::atomic<Node*> tail;
+};
+
+//---------------------------------------------------------------------------
+// Correctness check and throughput
+//---------------------------------------------------------------------------
+
+// Producers push distinct values while consumers pop; every value must come
+// out exactly once. For the queue, the values of one producer must also come
+// out in the order they went in.
+template <typename Container>
+bool checkContainer(const char* name, bool fifo) {
+    const int producers = 4;
+    const int consumers = 4;
+    const int perProducer = 50000;
+    Container container;
+    std::vector<std::vector<int>> seen(consumers);
+    std::atomic<int> producersDone{0};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < perProducer; ++i) {
+                container.push(p * perProducer + i);
+            }
+            producersDone.fetch_add(1);
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&, c] {
+            int value;
+            while (true) {
+                bool finished = producersDone.load() == producers;
+                if (container.tryPop(value)) {
+                    seen[c].push_back(value);
+                } else if (finished) {
+                    break;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    bool ok = true;
+    std::vector<int> all;
+    for (const auto& values : seen) {
+        if (fifo) {
+            std::vector<int> last(producers, -1);
+            for (int value : values) {
+                int p = value / perProducer;
+                ok = ok && value > last[p];
+                last[p] = value;
+            }
+        }
+        all.insert(all.end(), values.begin(), values.end());
+    }
+    std::sort(all.begin(), all.end());
+    ok = ok && all.size() == static_cast<std::size_t>(producers * perProducer);
+    for (std::size_t i = 0; ok && i < all.size(); ++i) {
+        ok = all[i] == static_cast<int>(i);
+    }
+    std::cout << name << (ok ? ": every item popped exactly once" : ": [MISMATCH]")
+              << (fifo && ok ? ", in order per producer" : "") << std::endl;
+    return ok;
+}
+
+// Every thread alternates push and tryPop on a prefilled container
+template <typename Container>
+double measureThroughput(std::size_t threads, std::size_t opsPerThread) {
+    Container container;
+    for (int i = 0; i < 1000; ++i) {
+        container.push(i);
+    }
+
+    std::atomic<bool> start{false};
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            int value = 0;
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for (std::size_t i = 0; i < opsPerThread; i += 2) {
+                container.push(static_cast<int>(t));
+                container.tryPop(value);
+            }
+        });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    return static_cast<double>(threads * opsPerThread) / elapsed.count();
+}
+
+int main(int argc, char* argv[]) {
+    LockFreeQueue<int> queue;
+    LockFreeStack<int> stack;
+    for (int i = 1; i <= 3; ++i) {
+        queue.push(i);
+        stack.push(i);
+    }
+    int value;
+    std::cout << "Queue pops:";
+    while (queue.tryPop(value)) {
+        std::cout << " " << value;
+    }
+    std::cout << "\nStack pops:";
+    while (stack.tryPop(value)) {
+        std::cout << " " << value;
+    }
+    std::cout << "\n" << std::endl;
+
+    checkContainer<LockedStack>("mutex + LinkedList stack", false);
+    checkContainer<LockFreeStack<int>>("Treiber stack", false);
+    checkContainer<LockedQueue>("mutex + LinkedList queue", true);
+    checkContainer<LockFreeQueue<int>>("Michael-Scott queue", true);
+
+    std::size_t opsPerThread = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    std::cout << "\nThroughput (50% push / 50% pop, Mops/s):" << std::endl;
+    std::cout << "threads  locked-stack  treiber  locked-queue  michael-scott" << std::endl;
+    for (std::size_t threads : {1, 2, 4, 8, 16, 32, 64}) {
+        std::cout << threads
+                  << "\t " << measureThroughput<LockedStack>(threads, opsPerThread) / 1e6
+                  << "\t       " << measureThroughput<LockFreeStack<int>>(threads, opsPerThread) / 1e6
+                  << "\t  " << measureThroughput<LockedQueue>(threads, opsPerThread) / 1e6
+                  << "\t\t" << measureThroughput<LockFreeQueue<int>>(threads, opsPerThread) / 1e6
+                  << std::endl;
+    }
+
+    return 0;
+}
+```
+
+This C++ code builds two lock-free containers on the singly linked node of `LinkedList.cpp`: a Treiber stack and a Michael-Scott queue. They are for passing work items between threads, which is currently done by putting a mutex around a `LinkedList`. Both containers free their nodes safely with hazard pointers, and both are checked under ThreadSanitizer.
+
+The code is divided into five main parts:
+
+1. The baseline: A compact copy of `LinkedList` with a `pop_front`, wrapped in a mutex as `LockedStack` (push and pop at the front) and `LockedQueue` (push at the back, pop at the front).
+
+2. `HazardPointers`: A small memory reclamation scheme shared by both containers.
+
+3. `LockFreeStack<T>`: The Treiber stack.
+
+4. `LockFreeQueue<T>`: The Michael-Scott queue.
+
+5. The main function: A small demo, a correctness check with four producers and four consumers, and a throughput table for 1 to 64 threads. The number of operations per thread can be passed as the first command line argument. To run the checks under ThreadSanitizer, compile with `g++ -std=c++20 -O1 -g -fsanitize=thread`.
+
+This code matters for several reasons:
+
+1. **No lock convoys**: With a mutex, a thread that is descheduled while holding the lock stops every other thread. In a lock-free container some thread always makes progress, because an operation only fails when another one succeeded.
+
+2. **Memory safety without garbage collection**: In a lock-free list, one thread can remove and delete a node while another thread is still reading it. Hazard pointers tell the removing thread which nodes are still in use, so they are deleted only after everyone is done with them.
+
+3. **The ABA problem**: A compare-and-swap only checks that the head pointer has the value it had before. If the node was popped, freed and a new node was allocated at the same address in the meantime, the CAS succeeds and corrupts the list. Because a protected node is never freed, its address cannot be reused while a thread still relies on it.
+
+4. **Measuring, not assuming**: Lock-free is not automatically faster. An uncontended mutex is cheap, and every lock-free operation pays for its atomic instructions and hazard pointer stores. The table shows where each approach wins on the machine at hand. On a single core, for example, the mutex versions are faster, because threads never really run at the same time and the lock is almost never contended.
+
+Here's a breakdown of the concepts used in the code:
+
+1. `std::atomic<Node*>` and `compare_exchange_weak`: The stack's `head`, and the queue's `head`, `tail` and `next` pointers, are atomic. `compare_exchange_weak(expected, desired)` stores `desired` only if the pointer still equals `expected`; otherwise it loads the current value into `expected` and returns `false`, and the loop tries again.
+
+2. Memory orders: `push` publishes a node with `memory_order_release`, and `tryPop` reads with `memory_order_acquire`. That guarantees the popping thread sees the data that was written into the node before it was pushed.
+
+3. `HazardPointers::protect(slot, source)`: Reads the pointer, stores it in one of the thread's hazard slots, and reads it again. If the value did not change, the node was still in the container after it was published, so no thread can free it anymore.
+
+4. `retire(node)`: Puts a removed node on the thread's retired list. When the list reaches twice the total number of hazard slots, `scan` collects all published pointers, sorts them, and deletes every retired node that is not among them. This keeps the cost of reclamation constant per node.
+
+5. `ThreadState`: Each thread claims a `Record` with its hazard slots the first time it uses a container. When the thread exits, its remaining retired nodes are handed to the `orphans` list, where the next scan on another thread picks them up, and the record becomes free for a new thread.
+
+6. Treiber stack: `push` points the new node at the current head and swings `head` to it. `tryPop` protects the head, then swings `head` to `head->next`. `next` is written before a node is published and never changed afterwards, so reading it needs no synchronization.
+
+7. Michael-Scott queue: The queue always holds a dummy node, so `head` and `tail` are never null. `push` links the new node after the last one and then moves `tail`; `tryPop` moves `head` forward and returns the data of the new dummy node. When a thread notices that `tail` has fallen behind, it moves it forward itself instead of waiting.
+
+8. `alignas(64)`: `head` and `tail` sit on separate cache lines, so threads that only push and threads that only pop do not slow each other down.
+
+9. `checkContainer`: Every producer pushes its own range of values. The check confirms that each value was popped exactly once and, for the queues, that each producer's values came out in the order they went in.
+
+Here are some common beginner mistakes to avoid with lock-free containers:
+
+1. **Deleting a node right after popping it**: Another thread may have loaded the same head a moment earlier and may be about to read `head->next`. The node must be retired, not deleted.
+
+2. **Forgetting to re-check after publishing a hazard pointer**: Publishing the pointer and then using it is not enough; the node may have been removed between the load and the store. Re-reading the source and comparing closes that gap.
+
+3. **Reading the data before winning the CAS**: In the queue, two threads can both see the same `next` node. Only the one whose `compare_exchange` succeeds owns the item; the other must not touch it.
+
+4. **Putting `head` and `tail` on one cache line**: Enqueuers and dequeuers then invalidate each other's cache line on every operation, even though they change different pointers.
+
+5. **Trusting a benchmark on a machine with few cores**: Lock-free containers show their strength when many threads really run in parallel. Run the table on the hardware you care about before deciding.
+
+6. **Ignoring ThreadSanitizer**: Data races in lock-free code often show up only once in millions of runs. Building with `-fsanitize=thread` finds them in seconds.
@@ -0,0 +1,820 @@
+```cpp
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <filesystem>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <cstddef>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+// A string -> int map whose table lives in a memory-mapped file, so a
+// restarted process gets its data back without rebuilding anything.
+//
+// A directory holds three files:
+//
+//   snapshot.0, snapshot.1   Two copies of the table (double buffering). Each
+//                            one is a header followed by the slot array and the
+//                            string pool, byte for byte as they are in memory.
+//   log                      Every put and remove since the newest snapshot,
+//                            appended as checksummed records.
+//
+// Opening maps the newest valid snapshot with MAP_PRIVATE and replays the log
+// on top of it. The mapping is copy-on-write: pages are read lazily on first
+// touch, and writes go to private copies instead of the file, so the snapshot
+// on disk stays intact no matter when the process dies. snapshot() writes the
+// table to the other snapshot file, and only then starts a new, empty log.
+// Opening therefore costs two header reads, one mmap and the replay of one log
+// that snapshot() keeps short; it does not depend on the size of the table.
+class PersistentMap {
+public:
+    explicit PersistentMap(const string &directory) : m_directory(directory) {
+        filesystem::create_directories(m_directory);
+        openSnapshot();
+        openLog();
+    }
+
+    // The table memory and the log descriptor belong to this object
+    PersistentMap(const PersistentMap &) = delete;
+    PersistentMap &operator=(const PersistentMap &) = delete;
+
+    // Records still in the buffer are written out, but nothing is fsynced: a
+    // clean shutdown is as durable as the last sync()
+    ~PersistentMap() {
+        try {
+            flush();
+        } catch (const exception &) {
+        }
+        if (m_logFd >= 0) {
+            ::close(m_logFd);
+        }
+        release();
+    }
+
+    // Add elements to the map. The change is logged before it is applied.
+    void put(string_view key, int value) {
+        appendRecord(kPut, key, value);
+        applyPut(key, value);
+    }
+
+    // Get the value associated with a key
+    int get(string_view key) const {
+        size_t index = find(key, hashKey(key));
+        if (index == npos) {
+            throw runtime_error("Key not found in the map.");
+        }
+        return slots()[index].value;
+    }
+
+    // Check if a key exists in the map
+    bool contains(string_view key) const {
+        return find(key, hashKey(key)) != npos;
+    }
+
+    // Remove a key from the map
+    void remove(string_view key) {
+        if (!contains(key)) {
+            throw runtime_error("Key not found in the map.");
+        }
+        appendRecord(kRemove, key, 0);
+        applyRemove(key);
+    }
+
+    // Iterate over the map
+    void for_each(const function<void(string_view, int)> &callback) const {
+        const Slot *table = slots();
+        for (size_t i = 0; i < header().capacity; ++i) {
+            if (table[i].tag >= kFirstFull) {
+                callback(keyOf(table[i]), table[i].value);
+            }
+        }
+    }
+
+    size_t size() const {
+        return header().size;
+    }
+
+    // Bytes in the log, including records that are still buffered
+    size_t log_bytes() const {
+        return m_logBytes + m_logBuffer.size();
+    }
+
+    uint64_t generation() const {
+        return header().generation;
+    }
+
+    // Hand buffered log records to the kernel. From then on they survive a
+    // crash of this process, but not a crash of the machine.
+    void flush() {
+        if (!m_logBuffer.empty()) {
+            writeAll(m_logFd, m_logBuffer.data(), m_logBuffer.size(), m_logBytes, "log");
+            m_logBytes += m_logBuffer.size();
+            m_logBuffer.clear();
+        }
+    }
+
+    // flush(), then wait until the log is on the disk
+    void sync() {
+        flush();
+        if (::fdatasync(m_logFd) != 0) {
+            fail("fdatasync", logPath());
+        }
+    }
+
+    // Write the table to the snapshot file that is not in use and empty the
+    // log. A crash at any point leaves one valid snapshot and a log that
+    // matches it:
+    //   - before the new header is written, the new file has no valid header
+    //     and the old snapshot plus the old log are used
+    //   - after it, the new snapshot has a newer generation than the log, so
+    //     the log is ignored; its records are already in the snapshot
+    void snapshot() {
+        flush();
+
+        int target = 1 - m_current;
+        string path = snapshotPath(target);
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            fail("open", path);
+        }
+        try {
+            Header next = header();
+            next.generation = header().generation + 1;
+            next.checksum = headerChecksum(next);
+
+            // The header goes last, so a half written file is never valid
+            if (::ftruncate(fd, static_cast<off_t>(m_bytes)) != 0) {
+                fail("ftruncate", path);
+            }
+            writeAll(fd, m_base + sizeof(Header), m_bytes - sizeof(Header), sizeof(Header), path);
+            if (::fdatasync(fd) != 0) {
+                fail("fdatasync", path);
+            }
+            writeAll(fd, reinterpret_cast<const char *>(&next), sizeof(Header), 0, path);
+            if (::fdatasync(fd) != 0) {
+                fail("fdatasync", path);
+            }
+        } catch (...) {
+            ::close(fd);
+            throw;
+        }
+        ::close(fd);
+        syncDirectory();
+
+        // Continue on a private mapping of the new snapshot, so that the next
+        // snapshot can overwrite the old file while nothing maps it
+        release();
+        mapSnapshot(path);
+        m_current = target;
+        resetLog();
+    }
+
+private:
+    // Slot tags: 0 is an empty slot, 1 a removed one, and a full slot stores
+    // the high 32 bits of the key's hash, moved up to at least kFirstFull
+    static constexpr uint32_t kEmptyTag = 0;
+    static constexpr uint32_t kDeletedTag = 1;
+    static constexpr uint32_t kFirstFull = 2;
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    static constexpr char kSnapshotMagic[8] = {'P', 'M', 'A', 'P', 'S', 'N', 'P', '1'};
+    static constexpr char kLogMagic[8] = {'P', 'M', 'A', 'P', 'L', 'O', 'G', '1'};
+    static constexpr uint8_t kPut = 1;
+    static constexpr uint8_t kRemove = 2;
+    static constexpr size_t kLogBufferSize = 64 * 1024;
+
+    // The table is one block of memory: Header, then capacity Slots, then
+    // poolCapacity bytes of key characters. The same bytes are the file
+    // format, so there is nothing to parse on open.
+    struct Header {
+        char magic[8];
+        uint64_t generation;
+        uint64_t capacity;      // slots, a power of two
+        uint64_t size;          // full slots
+        uint64_t used;          // full and removed slots
+        uint64_t poolCapacity;
+        uint64_t poolUsed;
+        uint64_t checksum;      // of the fields above
+    };
+
+    struct Slot {
+        uint32_t tag;
+        uint32_t keyOffset;     // into the string pool
+        uint32_t keyLength;
+        int32_t value;
+    };
+
+    struct LogHeader {
+        char magic[8];
+        uint64_t generation;    // of the snapshot the records apply to
+    };
+
+    struct Record {
+        uint32_t keyLength;
+        int32_t value;
+        uint32_t op;
+        uint32_t checksum;      // of the fields above and the key
+    };
+
+    string m_directory;
+    char *m_base = nullptr;     // the table, a private file mapping or anonymous memory
+    size_t m_bytes = 0;
+    int m_current = 0;          // the snapshot file the table came from
+    int m_logFd = -1;
+    size_t m_logBytes = 0;      // bytes of the log file, header included
+    vector<char> m_logBuffer;
+
+    Header &header() { return *reinterpret_cast<Header *>(m_base); }
+    const Header &header() const { return *reinterpret_cast<const Header *>(m_base); }
+    Slot *slots() { return reinterpret_cast<Slot *>(m_base + sizeof(Header)); }
+    const Slot *slots() const { return reinterpret_cast<const Slot *>(m_base + sizeof(Header)); }
+    char *pool() { return m_base + sizeof(Header) + header().capacity * sizeof(Slot); }
+    const char *pool() const { return m_base + sizeof(Header) + header().capacity * sizeof(Slot); }
+
+    string_view keyOf(const Slot &slot) const {
+        return string_view(pool() + slot.keyOffset, slot.keyLength);
+    }
+
+    static size_t tableBytes(uint64_t capacity, uint64_t poolCapacity) {
+        return sizeof(Header) + capacity * sizeof(Slot) + poolCapacity;
+    }
+
+    // FNV-1a. It is written out here because the file format must not change
+    // with the standard library, which std::hash does not promise.
+    static uint64_t fnv1a(const void *data, size_t length, uint64_t hash = 14695981039346656037ull) {
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < length; ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    static uint64_t hashKey(string_view key) {
+        uint64_t hash = fnv1a(key.data(), key.size());
+        // FNV leaves the low bits weak, and they pick the slot
+        hash ^= hash >> 32;
+        return hash * 0x9E3779B97F4A7C15ull;
+    }
+
+    static uint32_t tagOf(uint64_t hash) {
+        uint32_t tag = static_cast<uint32_t>(hash >> 32);
+        return tag < kFirstFull ? tag + kFirstFull : tag;
+    }
+
+    static uint64_t headerChecksum(const Header &h) {
+        return fnv1a(&h, offsetof(Header, checksum));
+    }
+
+    static uint32_t recordChecksum(const Record &record, string_view key) {
+        uint64_t hash = fnv1a(&record, offsetof(Record, checksum));
+        return static_cast<uint32_t>(fnv1a(key.data(), key.size(), hash));
+    }
+
+    [[noreturn]] static void fail(const char *what, const string &path) {
+        throw runtime_error(string(what) + " failed for " + path + ": " + strerror(errno));
+    }
+
+    static void writeAll(int fd, const char *data, size_t length, size_t offset, const string &path) {
+        while (length > 0) {
+            ssize_t written = ::pwrite(fd, data, length, static_cast<off_t>(offset));
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                fail("write", path);
+            }
+            data += written;
+            offset += static_cast<size_t>(written);
+            length -= static_cast<size_t>(written);
+        }
+    }
+
+    string snapshotPath(int index) const {
+        return m_directory + "/snapshot." + to_string(index);
+    }
+
+    string logPath() const {
+        return m_directory + "/log";
+    }
+
+    // A new file is only durable once its directory entry is
+    void syncDirectory() {
+        int fd = ::open(m_directory.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd >= 0) {
+            ::fsync(fd);
+            ::close(fd);
+        }
+    }
+
+    // Returns the snapshot's generation, or 0 if the file is missing, torn or
+    // not a snapshot
+    uint64_t readSnapshotHeader(const string &path) const {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return 0;
+        }
+        Header h;
+        struct stat info;
+        bool valid = ::pread(fd, &h, sizeof(h), 0) == static_cast<ssize_t>(sizeof(h)) && ::fstat(fd, &info) == 0 &&
+                     memcmp(h.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) == 0 && h.checksum == headerChecksum(h) &&
+                     static_cast<size_t>(info.st_size) == tableBytes(h.capacity, h.poolCapacity);
+        ::close(fd);
+        return valid ? h.generation : 0;
+    }
+
+    void openSnapshot() {
+        uint64_t first = readSnapshotHeader(snapshotPath(0));
+        uint64_t second = readSnapshotHeader(snapshotPath(1));
+        if (first == 0 && second == 0) {
+            allocate(1024, 64 * 1024);
+            memcpy(header().magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+            return;
+        }
+        m_current = second > first ? 1 : 0;
+        mapSnapshot(snapshotPath(m_current));
+    }
+
+    void mapSnapshot(const string &path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            fail("open", path);
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            fail("fstat", path);
+        }
+        m_bytes = static_cast<size_t>(info.st_size);
+        // MAP_PRIVATE with PROT_WRITE on a read-only descriptor: writes only
+        // ever reach private copies of the pages
+        void *memory = ::mmap(nullptr, m_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (memory == MAP_FAILED) {
+            fail("mmap", path);
+        }
+        m_base = static_cast<char *>(memory);
+    }
+
+    // Anonymous memory for a table that is not backed by a snapshot yet.
+    // It starts zeroed, i.e. with every slot empty.
+    void allocate(uint64_t capacity, uint64_t poolCapacity) {
+        m_bytes = tableBytes(capacity, poolCapacity);
+        void *memory = ::mmap(nullptr, m_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            throw bad_alloc();
+        }
+        m_base = static_cast<char *>(memory);
+        header().capacity = capacity;
+        header().poolCapacity = poolCapacity;
+    }
+
+    void release() {
+        if (m_base != nullptr) {
+            ::munmap(m_base, m_bytes);
+            m_base = nullptr;
+        }
+    }
+
+    // Replay the log if it belongs to the loaded snapshot, otherwise start a
+    // new one. Replay stops at the first torn or corrupt record, which is
+    // where the previous process died, and the log is cut there.
+    void openLog() {
+        m_logFd = ::open(logPath().c_str(), O_RDWR | O_CREAT, 0644);
+        if (m_logFd < 0) {
+            fail("open", logPath());
+        }
+        struct stat info;
+        if (::fstat(m_logFd, &info) != 0) {
+            fail("fstat", logPath());
+        }
+        vector<char> contents(static_cast<size_t>(info.st_size));
+        if (!contents.empty() && ::pread(m_logFd, contents.data(), contents.size(), 0) != info.st_size) {
+            fail("read", logPath());
+        }
+
+        LogHeader logHeader;
+        if (contents.size() < sizeof(LogHeader)) {
+            resetLog();
+            return;
+        }
+        memcpy(&logHeader, contents.data(), sizeof(LogHeader));
+        if (memcmp(logHeader.magic, kLogMagic, sizeof(kLogMagic)) != 0 || logHeader.generation != header().generation) {
+            resetLog();
+            return;
+        }
+
+        size_t offset = sizeof(LogHeader);
+        while (offset + sizeof(Record) <= contents.size()) {
+            Record record;
+            memcpy(&record, contents.data() + offset, sizeof(Record));
+            if (record.keyLength > contents.size() - offset - sizeof(Record)) {
+                break;
+            }
+            string_view key(contents.data() + offset + sizeof(Record), record.keyLength);
+            if (record.checksum != recordChecksum(record, key)) {
+                break;
+            }
+            if (record.op == kPut) {
+                applyPut(key, record.value);
+            } else if (record.op == kRemove) {
+                applyRemove(key);
+            } else {
+                break;
+            }
+            offset += sizeof(Record) + record.keyLength;
+        }
+
+        if (offset != contents.size() && ::ftruncate(m_logFd, static_cast<off_t>(offset)) != 0) {
+            fail("ftruncate", logPath());
+        }
+        m_logBytes = offset;
+    }
+
+    void resetLog() {
+        LogHeader logHeader;
+        memcpy(logHeader.magic, kLogMagic, sizeof(kLogMagic));
+        logHeader.generation = header().generation;
+        if (::ftruncate(m_logFd, 0) != 0) {
+            fail("ftruncate", logPath());
+        }
+        writeAll(m_logFd, reinterpret_cast<const char *>(&logHeader), sizeof(LogHeader), 0, logPath());
+        if (::fdatasync(m_logFd) != 0) {
+            fail("fdatasync", logPath());
+        }
+        m_logBytes = sizeof(LogHeader);
+        m_logBuffer.clear();
+    }
+
+    void appendRecord(uint8_t op, string_view key, int value) {
+        if (key.size() > UINT32_MAX) {
+            throw length_error("Key is too long.");
+        }
+        Record record;
+        record.keyLength = static_cast<uint32_t>(key.size());
+        record.value = value;
+        record.op = op;
+        record.checksum = recordChecksum(record, key);
+        const char *bytes = reinterpret_cast<const char *>(&record);
+        m_logBuffer.insert(m_logBuffer.end(), bytes, bytes + sizeof(Record));
+        m_logBuffer.insert(m_logBuffer.end(), key.begin(), key.end());
+        if (m_logBuffer.size() >= kLogBufferSize) {
+            flush();
+        }
+    }
+
+    size_t find(string_view key, uint64_t hash) const {
+        const Header &h = header();
+        const Slot *table = slots();
+        uint32_t tag = tagOf(hash);
+        size_t mask = h.capacity - 1;
+        for (size_t index = hash & mask;; index = (index + 1) & mask) {
+            if (table[index].tag == kEmptyTag) {
+                return npos;
+            }
+            if (table[index].tag == tag && keyOf(table[index]) == key) {
+                return index;
+            }
+        }
+    }
+
+    void applyPut(string_view key, int value) {
+        uint64_t hash = hashKey(key);
+        size_t index = find(key, hash);
+        if (index != npos) {
+            slots()[index].value = value;
+            return;
+        }
+
+        // Keep at most 70% of the slots in use, and room in the pool
+        if ((header().used + 1) * 10 > header().capacity * 7 || header().poolUsed + key.size() > header().poolCapacity) {
+            grow(key.size());
+        }
+
+        Header &h = header();
+        Slot *table = slots();
+        size_t mask = h.capacity - 1;
+        index = hash & mask;
+        while (table[index].tag >= kFirstFull) {
+            index = (index + 1) & mask;
+        }
+        if (table[index].tag == kEmptyTag) {
+            ++h.used;
+        }
+        memcpy(pool() + h.poolUsed, key.data(), key.size());
+        table[index] = Slot{tagOf(hash), static_cast<uint32_t>(h.poolUsed), static_cast<uint32_t>(key.size()), value};
+        h.poolUsed += key.size();
+        ++h.size;
+    }
+
+    // The key's characters stay in the pool until the next grow()
+    void applyRemove(string_view key) {
+        size_t index = find(key, hashKey(key));
+        if (index != npos) {
+            slots()[index].tag = kDeletedTag;
+            --header().size;
+        }
+    }
+
+    // Move every live entry into a new anonymous table. This also drops
+    // removed slots and the pool bytes of removed keys.
+    void grow(size_t extraKey) {
+        const Header old = header();
+        char *oldBase = m_base;
+        size_t oldBytes = m_bytes;
+
+        uint64_t capacity = old.capacity;
+        while ((old.size + 1) * 10 > capacity * 5) {
+            capacity *= 2;
+        }
+        uint64_t liveBytes = 0;
+        const Slot *oldSlots = reinterpret_cast<const Slot *>(oldBase + sizeof(Header));
+        for (size_t i = 0; i < old.capacity; ++i) {
+            if (oldSlots[i].tag >= kFirstFull) {
+                liveBytes += oldSlots[i].keyLength;
+            }
+        }
+        uint64_t poolCapacity = old.poolCapacity;
+        while (liveBytes + extraKey > poolCapacity / 2) {
+            poolCapacity *= 2;
+        }
+        if (poolCapacity > UINT32_MAX) {
+            throw length_error("String pool is full.");
+        }
+
+        m_base = nullptr;
+        allocate(capacity, poolCapacity);
+        memcpy(header().magic, old.magic, sizeof(old.magic));
+        header().generation = old.generation;
+
+        const char *oldPool = oldBase + sizeof(Header) + old.capacity * sizeof(Slot);
+        Header &h = header();
+        Slot *table = slots();
+        size_t mask = capacity - 1;
+        for (size_t i = 0; i < old.capacity; ++i) {
+            const Slot &slot = oldSlots[i];
+            if (slot.tag < kFirstFull) {
+                continue;
+            }
+            string_view key(oldPool + slot.keyOffset, slot.keyLength);
+            size_t index = hashKey(key) & mask;
+            while (table[index].tag != kEmptyTag) {
+                index = (index + 1) & mask;
+            }
+            memcpy(pool() + h.poolUsed, key.data(), key.size());
+            table[index] = Slot{slot.tag, static_cast<uint32_t>(h.poolUsed), slot.keyLength, slot.value};
+            h.poolUsed += key.size();
+        }
+        h.size = old.size;
+        h.used = old.size;
+
+        ::munmap(oldBase, oldBytes);
+    }
+};
+
+//---------------------------------------------------------------------------
+// Crash test: a child process writes until it is killed, the parent reopens
+// the map and checks that what survived is a consistent prefix of the writes
+//---------------------------------------------------------------------------
+
+string keyName(long i) {
+    return "key:" + to_string(i);
+}
+
+// Step i puts key i, removes key i - 50 on every hundredth step, and finally
+// records i under "last". Steps are idempotent, so a writer that restarts
+// after a crash simply redoes the step that was cut short.
+void writeSteps(PersistentMap &map, long first, long count, long snapshotEvery) {
+    for (long i = first; i < first + count; ++i) {
+        map.put(keyName(i), static_cast<int>(i));
+        if (i % 100 == 99 && map.contains(keyName(i - 50))) {
+            map.remove(keyName(i - 50));
+        }
+        map.put("last", static_cast<int>(i));
+        if (i % snapshotEvery == snapshotEvery - 1) {
+            map.snapshot();
+        }
+    }
+}
+
+bool removedBy(long key, long step) {
+    return step % 100 == 99 && key == step - 50;
+}
+
+// Returns the number of inconsistencies after the writes up to "last"
+long verify(const PersistentMap &map) {
+    long last = map.contains("last") ? map.get("last") : -1;
+    long errors = 0;
+    for (long i = 0; i <= last; ++i) {
+        // Step last + 1 may have been cut short, so its removal may or may
+        // not have happened. Everything else must be exactly as written.
+        if (removedBy(i, last + 1)) {
+            continue;
+        }
+        bool removed = i + 50 <= last && removedBy(i, i + 50);
+        if (removed ? map.contains(keyName(i)) : !map.contains(keyName(i)) || map.get(keyName(i)) != i) {
+            ++errors;
+        }
+    }
+    // The put of step last + 1 may have happened, later ones must not have
+    map.for_each([&](string_view key, int) {
+        if (key != "last" && stol(string(key.substr(4))) > last + 1) {
+            ++errors;
+        }
+    });
+    return errors;
+}
+
+void crashTest(const string &directory, int rounds) {
+    filesystem::remove_all(directory);
+    mt19937 random(2024);
+    cout << "\nCrash test: kill the writer at a random moment, then reopen" << endl;
+    for (int round = 1; round <= rounds; ++round) {
+        pid_t child = fork();
+        if (child < 0) {
+            throw runtime_error("fork failed");
+        }
+        if (child == 0) {
+            // Continue where the previous writer was killed
+            PersistentMap map(directory);
+            long next = map.contains("last") ? map.get("last") + 1 : 0;
+            writeSteps(map, next, 100000000, 50000);
+            _exit(0);
+        }
+
+        this_thread::sleep_for(chrono::milliseconds(200 + random() % 600));
+        kill(child, SIGKILL);
+        waitpid(child, nullptr, 0);
+
+        auto start = chrono::steady_clock::now();
+        PersistentMap map(directory);
+        chrono::duration<double, milli> openMs = chrono::steady_clock::now() - start;
+        long errors = verify(map);
+        cout << "round " << round << ": recovered " << map.size() << " keys, last step " << map.get("last")
+             << ", generation " << map.generation() << ", log " << map.log_bytes() << " bytes, opened in " << openMs.count()
+             << " ms";
+        if (errors != 0) {
+            cout << "  [MISMATCH] " << errors << " inconsistent keys";
+        }
+        cout << endl;
+    }
+}
+
+//---------------------------------------------------------------------------
+// Benchmark: restarting by replaying the log vs. mapping a snapshot
+//---------------------------------------------------------------------------
+
+template <typename Function>
+double timeMs(Function run) {
+    auto start = chrono::steady_clock::now();
+    run();
+    chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+void benchmarkRestart(const string &directory, long keys) {
+    filesystem::remove_all(directory);
+    cout << "\n" << keys << " keys" << endl;
+
+    double writeMs = timeMs([&] {
+        PersistentMap map(directory);
+        for (long i = 0; i < keys; ++i) {
+            map.put(keyName(i), static_cast<int>(i));
+        }
+    });
+    cout << "put + log:                 " << writeMs << " ms" << endl;
+
+    double snapshotMs = 0;
+    {
+        optional<PersistentMap> map;
+        double replayMs = timeMs([&] { map.emplace(directory); });
+        cout << "restart by replaying log:  " << replayMs << " ms";
+        if (map->size() != static_cast<size_t>(keys)) {
+            cout << "  [MISMATCH]";
+        }
+        cout << endl;
+        snapshotMs = timeMs([&] { map->snapshot(); });
+    }
+    cout << "snapshot:                  " << snapshotMs << " ms" << endl;
+
+    mt19937 random(7);
+    long long sum = 0;
+    long long expected = 0;
+    double openMs = 0;
+    double lookupMs = 0;
+    {
+        optional<PersistentMap> map;
+        openMs = timeMs([&] { map.emplace(directory); });
+        // The pages are only read on first touch, so the first lookups pay
+        // for the faults
+        lookupMs = timeMs([&] {
+            for (int i = 0; i < 1000; ++i) {
+                long key = static_cast<long>(random() % keys);
+                sum += map->get(keyName(key));
+                expected += key;
+            }
+        });
+    }
+    cout << "restart from snapshot:     " << openMs << " ms";
+    if (sum != expected) {
+        cout << "  [MISMATCH]";
+    }
+    cout << endl;
+    cout << "first 1000 lookups:        " << lookupMs << " ms" << endl;
+    filesystem::remove_all(directory);
+}
+
+int main(int argc, char *argv[]) {
+    string directory = (filesystem::temp_directory_path() / "PersistentMap").string();
+    filesystem::remove_all(directory);
+    {
+        PersistentMap map(directory);
+
+        // Add elements to the map
+        map.put("apple", 1);
+        map.put("banana", 2);
+        map.put("cherry", 3);
+        map.remove("banana");
+        map.snapshot();
+        map.put("date", 4);
+    }
+
+    // A second instance finds the snapshot and the logged put of "date"
+    PersistentMap reopened(directory);
+    reopened.for_each([](string_view key, int value) { cout << key << ": " << value << endl; });
+    cout << "Contains banana: " << (reopened.contains("banana") ? "yes" : "no") << endl;
+
+    int rounds = argc > 2 ? atoi(argv[2]) : 5;
+    crashTest(directory + "-crash", rounds);
+    filesystem::remove_all(directory + "-crash");
+
+    long keys = argc > 1 ? atol(argv[1]) : 5000000;
+    benchmarkRestart(directory + "-bench", keys);
+
+    filesystem::remove_all(directory);
+    return 0;
+}
+```
+
+This code snippet implements a persistent version of the string-to-int map from `Map.cpp`. The table lives in a memory-mapped file with a fixed layout, so a restarted process gets its data back in well under a millisecond instead of rebuilding the map from its logs. The main function shows a map that survives being closed and reopened, kills a writing process at random moments and checks that everything written before the kill is recovered, and compares restarting from the log with restarting from a snapshot.
+
+This code matters for several reasons:
+
+1. **Restart time**: A service that rebuilds its tables from a log on every start is unavailable for as long as the replay takes, and the replay grows with the data. Mapping a file whose bytes already are the table costs the same for ten keys and for ten million; pages are read when they are first used.
+
+2. **Crash safety**: A process can be killed between any two instructions. The files must be arranged so that every such moment leaves something that can be recovered, and the reader must be able to tell a complete file or record from a half written one.
+
+3. **Snapshots without stopping the world**: Writes never touch the snapshot the table was loaded from, so a new snapshot can be written from the live table while the old one stays valid until the new one is complete.
+
+4. **Bounded logs**: Each snapshot empties the log, so the work done on open is limited to the writes since the last snapshot.
+
+Here's a breakdown of the concepts used in the code:
+
+1. The layout: The table is one block of memory with a `Header`, then `capacity` slots of 16 bytes, then the string pool holding the key characters. A `Slot` refers to its key by offset and length into the pool, never by pointer, so the block means the same thing at any address. Writing the block to a file and mapping it back gives the same table.
+
+2. Slot tags: A slot is empty (tag 0), removed (tag 1) or full, in which case the tag holds 32 bits of the key's hash. Lookups probe linearly and compare the key only when the tag matches.
+
+3. `openSnapshot` and `mapSnapshot`: Read the headers of `snapshot.0` and `snapshot.1`, keep the valid one with the highest generation and map it with `MAP_PRIVATE`. A private mapping is copy-on-write: the first write to a page gives the process its own copy, and the file is never modified.
+
+4. The log: `put` and `remove` append a `Record` (key length, value, operation, checksum) and the key to a buffer before changing the table. The buffer is written to the log file every 64 KB, on `flush()`, `sync()`, `snapshot()` and in the destructor. `flush()` makes the records survive a crash of the process; `sync()` also calls `fdatasync`, which makes them survive a power loss.
+
+5. `openLog`: The log starts with the generation of the snapshot it belongs to. If it matches the loaded snapshot, its records are replayed until the first record that is cut off or whose checksum is wrong, and the file is truncated there. Otherwise the log is older than the snapshot and is replaced by an empty one.
+
+6. `snapshot()`: Writes the table to the snapshot file that is not in use: first everything after the header, then `fdatasync`, then the header with the next generation, then `fdatasync` again. A file whose header was not written yet is never valid. After that, the table is remapped from the new file and the log is emptied. If the process dies before the header is written, the old snapshot and the old log are used; if it dies after, the new snapshot is used and the old log is ignored because its generation is older.
+
+7. `grow`: When the table is 70% full or the pool runs out of room, the live entries are copied into a larger block of anonymous memory. This also drops removed slots and the pool bytes of removed keys. The next `snapshot()` writes the larger table out.
+
+8. `fnv1a`: The hash and the checksums are part of the file format, so they are written out by hand. `std::hash` may differ between standard libraries and versions.
+
+9. The crash test: `crashTest` forks a child that writes steps until the parent kills it with `SIGKILL` at a random moment, sometimes in the middle of a snapshot. The parent reopens the map and `verify` checks that the result is exactly the writes up to the step stored under `"last"`, allowing only the step after it to be partly applied. Each round's writer continues where the previous one died. The number of rounds can be passed as the second command line argument.
+
+10. `benchmarkRestart`: Writes 5 million keys (or the first command line argument), then times a restart that replays the whole log, a snapshot, a restart from the snapshot, and the first 1000 lookups after it, which pay for reading the pages they touch.
+
+Here are some common beginner mistakes to avoid with persistent data structures:
+
+1. **Storing pointers in the file**: A pointer is only valid in the process that created it. A file that is mapped back in at a different address needs offsets.
+
+2. **Updating the only copy in place**: If the table on disk is modified directly, a crash in the middle of an update leaves it half old and half new with no way to tell. Keep a complete copy that is never modified until a new complete copy exists.
+
+3. **Writing the commit marker too early**: The header that makes a snapshot valid must be written after the rest of the file has reached the disk, with an `fdatasync` in between, or the disk may store the header first.
+
+4. **Trusting the end of the log**: The last record in a log may be cut off by the crash. Check the length and a checksum of every record, and stop at the first bad one.
+
+5. **Replaying a log over the wrong snapshot**: Records that are already in the snapshot must not be applied again, and a `remove` that is replayed after a newer `put` would lose data. Tag the log with the snapshot it belongs to.
+
+6. **Confusing `write` with durability**: `write` only hands the data to the kernel. It survives the process being killed but not the machine losing power; only `fsync` or `fdatasync` waits for the disk.
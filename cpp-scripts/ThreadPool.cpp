@@ -0,0 +1,657 @@
+```cpp
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <future>
+#include <functional>
+#include <exception>
+#include <type_traits>
+#include <utility>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <pthread.h>
+#include <sched.h>
+
+// A unit of work. run() is called exactly once, by whichever thread takes
+// the task; tasks on the heap delete themselves at the end of run().
+class Task {
+public:
+    virtual ~Task() = default;
+    virtual void run() = 0;
+};
+
+template <typename Function>
+class HeapTask : public Task {
+public:
+    explicit HeapTask(Function function) : function(std::move(function)) {}
+
+    void run() override {
+        function();
+        delete this;
+    }
+
+private:
+    Function function;
+};
+
+// The deque of one worker (Chase and Lev, with the memory orders of Lê et
+// al., "Correct and Efficient Work-Stealing for Weak Memory Models"). The
+// owner pushes and pops at the bottom without any atomic read-modify-write,
+// except when only one task is left. Other workers steal from the top with a
+// compare-and-swap. The array grows when it is full; old arrays are kept
+// until the deque is destroyed, because a thief may still be reading one.
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(int64_t capacity = 256) {
+        arrays.push_back(std::make_unique<Array>(capacity));
+        array.store(arrays.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // Owner only
+    void push(Task* task) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        Array* a = array.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1) {
+            a = grow(a, t, b);
+        }
+        a->put(b, task);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only. Returns the most recently pushed task, or nullptr.
+    Task* pop() {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Array* a = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Task* task = a->get(b);
+        if (t == b) {
+            // The last task: a thief may be taking it at the same moment
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                task = nullptr;
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    // Any thread. Returns the oldest task, or nullptr if the deque is empty
+    // or another thread got there first.
+    Task* steal() {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return nullptr;
+        }
+        Task* task = array.load(std::memory_order_acquire)->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return task;
+    }
+
+    bool empty() const {
+        return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Array {
+        const int64_t capacity;  // a power of two
+        std::unique_ptr<std::atomic<Task*>[]> slots;
+
+        explicit Array(int64_t capacity) : capacity(capacity), slots(new std::atomic<Task*>[capacity]) {}
+
+        // Release and acquire on the slot itself publish the task to a thief;
+        // on x86 they cost the same as relaxed accesses
+        Task* get(int64_t i) const { return slots[i & (capacity - 1)].load(std::memory_order_acquire); }
+        void put(int64_t i, Task* task) { slots[i & (capacity - 1)].store(task, std::memory_order_release); }
+    };
+
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+    std::atomic<Array*> array;
+    std::vector<std::unique_ptr<Array>> arrays;  // touched by the owner only
+
+    Array* grow(Array* old, int64_t t, int64_t b) {
+        arrays.push_back(std::make_unique<Array>(old->capacity * 2));
+        Array* bigger = arrays.back().get();
+        for (int64_t i = t; i < b; ++i) {
+            bigger->put(i, old->get(i));
+        }
+        array.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+};
+
+// Idle workers spin for a moment and then sleep in std::atomic::wait. A
+// thread that adds work calls wake(), which costs a fence and a load unless
+// somebody is asleep.
+class IdleWait {
+public:
+    template <typename Ready>
+    void wait(Ready ready) {
+        for (int spin = 0; spin < 64; ++spin) {
+            if (ready()) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+        uint32_t seen = signal.load(std::memory_order_acquire);
+        sleepers.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!ready()) {
+            signal.wait(seen, std::memory_order_acquire);
+        }
+    }
+
+    void wake() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_relaxed) > 0) {
+            sleepers.exchange(0, std::memory_order_seq_cst);
+            signal.fetch_add(1, std::memory_order_release);
+            signal.notify_all();
+        }
+    }
+
+private:
+    std::atomic<uint32_t> sleepers{0};
+    std::atomic<uint32_t> signal{0};
+};
+
+// Pins a thread to one CPU, so the scheduler does not move it and its
+// caches stay warm. Returns false if the system refuses.
+bool pinToCpu(std::thread& thread, unsigned cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+}
+
+// A pool of worker threads that share work by stealing. Tasks spawned by a
+// worker go to the bottom of its own deque, where it picks them up again
+// last in, first out, while their data is still in its cache. A worker with
+// nothing to do steals the oldest task of another worker, which in a
+// divide-and-conquer algorithm is the largest piece of work left. Tasks from
+// threads outside the pool go into a shared queue.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads = std::thread::hardware_concurrency(), bool pin = false)
+        : workers(std::max<size_t>(threads, 1)) {
+        unsigned cpus = std::max(1u, std::thread::hardware_concurrency());
+        for (size_t i = 0; i < workers.size(); ++i) {
+            workers[i].thread = std::thread([this, i] { workerLoop(i); });
+            if (pin && pinToCpu(workers[i].thread, static_cast<unsigned>(i % cpus))) {
+                ++pinnedCount;
+            }
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Finishes the queued tasks, then stops the workers
+    ~ThreadPool() {
+        stopping.store(true, std::memory_order_release);
+        idle.wake();
+        for (auto& worker : workers) {
+            worker.thread.join();
+        }
+    }
+
+    size_t size() const { return workers.size(); }
+
+    // Number of workers whose pinning succeeded
+    size_t pinned() const { return pinnedCount; }
+
+    // Run function on the pool. The future holds its result, or the
+    // exception it threw.
+    template <typename Function>
+    auto submit(Function function) -> std::future<std::invoke_result_t<Function&>> {
+        using Result = std::invoke_result_t<Function&>;
+        std::packaged_task<Result()> job(std::move(function));
+        std::future<Result> result = job.get_future();
+        schedule(new HeapTask<std::packaged_task<Result()>>(std::move(job)));
+        return result;
+    }
+
+    // Run a and b, possibly in parallel, and return when both are done. The
+    // calling worker offers b to the others, runs a itself, and then takes b
+    // back if nobody stole it. While b runs elsewhere, the caller executes
+    // other tasks instead of blocking, which is why fork-join nested to any
+    // depth cannot run out of threads. An exception from either is rethrown.
+    template <typename A, typename B>
+    void fork_join(A&& a, B&& b) {
+        if (currentPool != this) {
+            submit([&] { fork_join(a, b); }).get();
+            return;
+        }
+        JoinTask<B> forked(b);
+        Worker& self = workers[currentIndex];
+        self.deque.push(&forked);
+        idle.wake();
+        std::exception_ptr error;
+        try {
+            a();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        while (!forked.done.load(std::memory_order_acquire)) {
+            if (Task* task = self.deque.pop()) {
+                task->run();  // usually forked itself, back from the deque
+            } else if (Task* stolen = findTask(currentIndex)) {
+                stolen->run();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        if (forked.error) {
+            std::rethrow_exception(forked.error);
+        }
+    }
+
+    // Call body(i) for every i in [begin, end). The range is split in halves
+    // with fork_join down to pieces of grain indices; 0 picks a grain that
+    // gives every worker about eight pieces, enough to even out the load
+    // without paying for millions of tasks.
+    template <typename Body>
+    void parallel_for(size_t begin, size_t end, Body body, size_t grain = 0) {
+        if (begin >= end) {
+            return;
+        }
+        if (grain == 0) {
+            grain = autoGrain(end - begin);
+        }
+        forRange(begin, end, grain, body);
+    }
+
+    // reduce(map(begin), ..., map(end - 1)), starting from identity, split
+    // like parallel_for. reduce must be associative.
+    template <typename T, typename Map, typename Reduce>
+    T parallel_reduce(size_t begin, size_t end, T identity, Map map, Reduce reduce, size_t grain = 0) {
+        if (begin >= end) {
+            return identity;
+        }
+        if (grain == 0) {
+            grain = autoGrain(end - begin);
+        }
+        return reduceRange(begin, end, grain, identity, map, reduce);
+    }
+
+private:
+    struct Worker {
+        WorkStealingDeque deque;
+        std::thread thread;
+    };
+
+    // The task that fork_join offers to the other workers. It lives on the
+    // stack of the forking thread, which waits for done before returning.
+    template <typename Function>
+    struct JoinTask : Task {
+        Function& function;
+        std::exception_ptr error;
+        std::atomic<bool> done{false};
+
+        explicit JoinTask(Function& function) : function(function) {}
+
+        void run() override {
+            try {
+                function();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            done.store(true, std::memory_order_release);
+        }
+    };
+
+    std::vector<Worker> workers;
+    std::mutex injectedMtx;
+    std::deque<Task*> injected;
+    std::atomic<size_t> injectedCount{0};
+    std::atomic<bool> stopping{false};
+    size_t pinnedCount = 0;
+    IdleWait idle;
+
+    static thread_local ThreadPool* currentPool;
+    static thread_local size_t currentIndex;
+
+    void schedule(Task* task) {
+        if (currentPool == this) {
+            workers[currentIndex].deque.push(task);
+        } else {
+            std::lock_guard<std::mutex> lock(injectedMtx);
+            injected.push_back(task);
+            injectedCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        idle.wake();
+    }
+
+    // Own deque first, then the shared queue, then the other workers,
+    // starting from a random one so that thieves spread out
+    Task* findTask(size_t self) {
+        if (Task* task = workers[self].deque.pop()) {
+            return task;
+        }
+        if (injectedCount.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(injectedMtx);
+            if (!injected.empty()) {
+                Task* task = injected.front();
+                injected.pop_front();
+                injectedCount.fetch_sub(1, std::memory_order_relaxed);
+                return task;
+            }
+        }
+        thread_local std::minstd_rand random(static_cast<unsigned>(self) + 1);
+        size_t start = random() % workers.size();
+        for (size_t k = 0; k < workers.size(); ++k) {
+            size_t victim = (start + k) % workers.size();
+            if (victim != self) {
+                if (Task* task = workers[victim].deque.steal()) {
+                    return task;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    bool workAvailable() const {
+        if (injectedCount.load(std::memory_order_relaxed) > 0) {
+            return true;
+        }
+        for (const auto& worker : workers) {
+            if (!worker.deque.empty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(size_t index) {
+        currentPool = this;
+        currentIndex = index;
+        while (true) {
+            if (Task* task = findTask(index)) {
+                task->run();
+            } else if (stopping.load(std::memory_order_acquire) && !workAvailable()) {
+                break;
+            } else {
+                idle.wait([this] { return workAvailable() || stopping.load(std::memory_order_acquire); });
+            }
+        }
+    }
+
+    size_t autoGrain(size_t count) const {
+        return std::max<size_t>(1, count / (8 * workers.size()));
+    }
+
+    template <typename Body>
+    void forRange(size_t begin, size_t end, size_t grain, Body& body) {
+        if (end - begin <= grain) {
+            for (size_t i = begin; i < end; ++i) {
+                body(i);
+            }
+            return;
+        }
+        size_t middle = begin + (end - begin) / 2;
+        fork_join([&] { forRange(begin, middle, grain, body); }, [&] { forRange(middle, end, grain, body); });
+    }
+
+    template <typename T, typename Map, typename Reduce>
+    T reduceRange(size_t begin, size_t end, size_t grain, const T& identity, Map& map, Reduce& reduce) {
+        if (end - begin <= grain) {
+            T result = identity;
+            for (size_t i = begin; i < end; ++i) {
+                result = reduce(result, map(i));
+            }
+            return result;
+        }
+        size_t middle = begin + (end - begin) / 2;
+        T left = identity;
+        T right = identity;
+        fork_join([&] { left = reduceRange(begin, middle, grain, identity, map, reduce); },
+                  [&] { right = reduceRange(middle, end, grain, identity, map, reduce); });
+        return reduce(left, right);
+    }
+};
+
+thread_local ThreadPool* ThreadPool::currentPool = nullptr;
+thread_local size_t ThreadPool::currentIndex = 0;
+
+//---------------------------------------------------------------------------
+// Benchmarks
+//---------------------------------------------------------------------------
+
+template <typename Function>
+double timeMs(Function run) {
+    auto start = std::chrono::steady_clock::now();
+    run();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+// A fine-grained task: about a hundred nanoseconds of arithmetic
+uint64_t smallWork(uint64_t x) {
+    for (int i = 0; i < 32; ++i) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+    }
+    return x;
+}
+
+void report(const char* name, double ms, size_t tasks, bool correct) {
+    std::cout << name << ms * 1e6 / static_cast<double>(tasks) << " ns per task (" << tasks << " tasks, " << ms
+              << " ms)";
+    if (!correct) {
+        std::cout << "  [MISMATCH]";
+    }
+    std::cout << std::endl;
+}
+
+// The same number of small tasks, run four ways. Starting a thread costs
+// tens of microseconds, so the thread-per-task versions run fewer tasks and
+// are compared per task.
+void benchmarkTasks(ThreadPool& pool, size_t tasks, size_t threadTasks) {
+    uint64_t expected = 0;
+    for (size_t i = 0; i < tasks; ++i) {
+        expected += smallWork(i);
+    }
+    uint64_t expectedFew = 0;
+    for (size_t i = 0; i < threadTasks; ++i) {
+        expectedFew += smallWork(i);
+    }
+
+    std::cout << "\nFine-grained tasks on " << pool.size() << " workers" << std::endl;
+    std::vector<uint64_t> results(std::max(tasks, threadTasks));
+    double ms = timeMs([&] {
+        std::vector<std::thread> threads;
+        threads.reserve(threadTasks);
+        for (size_t i = 0; i < threadTasks; ++i) {
+            threads.emplace_back([&results, i] { results[i] = smallWork(i); });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+    });
+    uint64_t sum = 0;
+    for (size_t i = 0; i < threadTasks; ++i) {
+        sum += results[i];
+    }
+    report("std::thread per task:       ", ms, threadTasks, sum == expectedFew);
+
+    ms = timeMs([&] {
+        std::vector<std::future<uint64_t>> futures;
+        futures.reserve(threadTasks);
+        for (size_t i = 0; i < threadTasks; ++i) {
+            futures.push_back(std::async(std::launch::async, [i] { return smallWork(i); }));
+        }
+        sum = 0;
+        for (auto& f : futures) {
+            sum += f.get();
+        }
+    });
+    report("std::async per task:        ", ms, threadTasks, sum == expectedFew);
+
+    ms = timeMs([&] {
+        std::vector<std::future<uint64_t>> futures;
+        futures.reserve(tasks);
+        for (size_t i = 0; i < tasks; ++i) {
+            futures.push_back(pool.submit([i] { return smallWork(i); }));
+        }
+        sum = 0;
+        for (auto& f : futures) {
+            sum += f.get();
+        }
+    });
+    report("ThreadPool::submit:         ", ms, tasks, sum == expected);
+
+    ms = timeMs([&] { pool.parallel_for(0, tasks, [&](size_t i) { results[i] = smallWork(i); }); });
+    sum = 0;
+    for (size_t i = 0; i < tasks; ++i) {
+        sum += results[i];
+    }
+    report("ThreadPool::parallel_for:   ", ms, tasks, sum == expected);
+
+    ms = timeMs([&] {
+        sum = pool.parallel_reduce(size_t{0}, tasks, uint64_t{0}, [](size_t i) { return smallWork(i); },
+                                   [](uint64_t a, uint64_t b) { return a + b; });
+    });
+    report("ThreadPool::parallel_reduce: ", ms, tasks, sum == expected);
+
+    ms = timeMs([&] {
+        sum = 0;
+        for (size_t i = 0; i < tasks; ++i) {
+            sum += smallWork(i);
+        }
+    });
+    report("serial loop:                ", ms, tasks, sum == expected);
+}
+
+// Fibonacci with a fork_join at every level above the cutoff: a tree of
+// nested forks, each waiting for its children
+uint64_t fib(ThreadPool& pool, int n, int cutoff) {
+    if (n < 2) {
+        return static_cast<uint64_t>(n);
+    }
+    if (n <= cutoff) {
+        return fib(pool, n - 1, cutoff) + fib(pool, n - 2, cutoff);
+    }
+    uint64_t a = 0;
+    uint64_t b = 0;
+    pool.fork_join([&] { a = fib(pool, n - 1, cutoff); }, [&] { b = fib(pool, n - 2, cutoff); });
+    return a + b;
+}
+
+void benchmarkForkJoin(ThreadPool& pool, int n) {
+    std::cout << "\nNested fork-join: fib(" << n << ")" << std::endl;
+    uint64_t serial = 0;
+    double ms = timeMs([&] { serial = fib(pool, n, n); });
+    std::cout << "serial:               " << ms << " ms" << std::endl;
+    for (int cutoff : {n - 10, 20, 10}) {
+        uint64_t result = 0;
+        double forkMs = timeMs([&] { result = pool.submit([&] { return fib(pool, n, cutoff); }).get(); });
+        std::cout << "fork_join above " << cutoff << ":  " << forkMs << " ms";
+        if (result != serial) {
+            std::cout << "  [MISMATCH]";
+        }
+        std::cout << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t tasks = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    size_t threadTasks = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10000;
+    size_t threads = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : std::thread::hardware_concurrency();
+
+    ThreadPool pool(threads, true);
+    std::cout << pool.size() << " workers, " << pool.pinned() << " pinned" << std::endl;
+
+    // A future carries the result, or the exception
+    std::future<int> answer = pool.submit([] { return 6 * 7; });
+    std::future<void> failure = pool.submit([] { throw std::runtime_error("task failed"); });
+    std::cout << "Answer: " << answer.get() << std::endl;
+    try {
+        failure.get();
+    } catch (const std::exception& e) {
+        std::cout << "Caught: " << e.what() << std::endl;
+    }
+
+    benchmarkTasks(pool, tasks, threadTasks);
+    benchmarkForkJoin(pool, 32);
+    return 0;
+}
+```
+
+This C++ code is a work-stealing thread pool. Every worker thread has its own Chase-Lev deque of tasks, and a worker that runs out of work steals from the others. On top of it, `submit` runs a function and returns a `std::future` for its result, `fork_join` runs two functions in parallel and waits for both, and `parallel_for` and `parallel_reduce` split a range of indices into pieces of an automatically chosen size. Worker threads can be pinned to CPUs. The main function submits a task that returns a value and one that throws. It then runs a million small tasks through the pool and compares them with a thread per task and `std::async`, and it computes Fibonacci numbers with fork-join nested 22 levels deep.
+
+This code matters for several reasons:
+
+1. **The cost of a thread**: Creating, starting and joining a thread takes tens of microseconds, and `std::async` with `std::launch::async` starts a new thread for every call too. A task that does a hundred nanoseconds of work is lost in that overhead. A pool starts its threads once and hands each of them many tasks.
+
+2. **Work stealing**: A single shared queue is simple, but every task goes through the same lock or the same atomic, and with many workers that becomes the bottleneck. With one deque per worker, a worker pushes and pops its own tasks without contention, and the threads only meet when one of them runs out of work and steals.
+
+3. **Locality**: A worker takes its own tasks last in, first out, so the task it runs next is the one it created most recently, whose data is most likely still in its cache. Thieves take the oldest task, which in a divide-and-conquer algorithm is the largest piece left, so a single steal gives the thief plenty of work.
+
+4. **Nested parallelism without deadlock**: In a pool where a task blocks while waiting for the tasks it created, nested waits can occupy every thread, and the tasks they wait for never run. `fork_join` never blocks: while it waits for its second half, the thread keeps executing tasks, starting with that half if nobody stole it.
+
+5. **Grain size**: Splitting a loop into one task per index drowns the work in scheduling overhead; splitting it into one piece per thread leaves threads idle when the pieces take different times. About eight pieces per worker is a good default for both.
+
+Here's a breakdown of the concepts used in the code:
+
+1. `Task`: The unit of work, an object with a virtual `run()`. `HeapTask<Function>` wraps a function allocated with `new` and deletes itself after running. `JoinTask` lives on the stack of `fork_join` and only sets its `done` flag, so forking costs no allocation.
+
+2. `WorkStealingDeque`: The deque of Chase and Lev, with the memory orders from Lê et al. The owner pushes and pops at `bottom`; thieves take from `top` with a compare-and-swap. The owner only needs a compare-and-swap when a single task is left, because then it can race with a thief for it. The `seq_cst` fences in `pop` and `steal` make sure that the owner and a thief cannot both see the last task as theirs. When the array is full, `grow` copies the tasks into one twice as large. The old array stays alive until the deque is destroyed, because a thief that loaded the old pointer may still read from it.
+
+3. The shared queue: A thread outside the pool has no deque, so `submit` from the main thread puts the task into `injected`, a `std::deque` behind a mutex. `injectedCount` lets the workers skip the lock while it is empty.
+
+4. `currentPool` and `currentIndex`: `thread_local` variables that tell a thread whether it is a worker of this pool, and which one. A task submitted by a worker goes into that worker's own deque.
+
+5. `findTask`: The worker's search order: its own deque, then the shared queue, then the other workers, starting from a random one so that several thieves do not all attack the same victim.
+
+6. `IdleWait`: A worker that finds nothing yields a few times and then sleeps on a futex through `std::atomic::wait`. `wake()` only makes a system call when somebody is asleep. The `seq_cst` fences on both sides guarantee that either the sleeper sees the new task or the waker sees the sleeper.
+
+7. `submit`: Wraps the function in a `std::packaged_task`, which stores the result, or the exception, in the shared state of the `std::future`.
+
+8. `fork_join(a, b)`: Pushes `b` as a `JoinTask`, runs `a`, and then loops until `b` is done: it pops its own deque, which usually returns `b` itself, or steals from the others while a thief runs `b`. Exceptions from `a` and `b` are caught and rethrown after both have finished, so `b` never outlives the stack frame it refers to. Called from outside the pool, it submits itself and waits on the future.
+
+9. `parallel_for` and `parallel_reduce`: Split the range in half with `fork_join` until a piece has at most `grain` indices, and run each piece as a plain loop. `parallel_reduce` combines the results of the halves with `reduce`, which must be associative for the result to match a serial loop.
+
+10. Pinning: With `pin` set, the constructor calls `pthread_setaffinity_np` on each new thread to bind worker `i` to CPU `i` modulo the number of CPUs. A pinned thread is never migrated, which keeps its cache warm, but it also cannot move away from a core that another program is using. `pinned()` reports how many workers the system actually pinned.
+
+11. The benchmark: `smallWork` is about a hundred nanoseconds of integer hashing. `benchmarkTasks` runs it as a thread per task and as `std::async` (10,000 tasks by default), and then as one million pool tasks through `submit`, `parallel_for` and `parallel_reduce` and as a serial loop, and prints the time per task. `benchmarkForkJoin` computes `fib(32)` with `fork_join` at every level above a cutoff, so that the smallest cutoff creates tens of thousands of nested joins. Every result is checked against a serial computation, and a wrong result prints `[MISMATCH]`. The number of tasks, the number of thread-per-task tasks, and the number of workers can be passed on the command line. On a single-core machine, a thread per task costs about 50 µs, `submit` about 1 µs (most of it is waking the sleeping worker and the two allocations of the task and its future), and `parallel_for` and `parallel_reduce` stay within 15% of the serial loop. With only one core, nothing runs in parallel, so the numbers show the overhead of the pool rather than its speed-up.
+
+For a beginner, there are several common mistakes that can be made in this C++ code:
+
+1. **Blocking on a future inside a task**: A pool task that calls `get()` on the future of another task blocks a worker. With enough of them, all workers wait and the pool deadlocks. Use `fork_join` inside the pool, which keeps the waiting thread working.
+
+2. **A task per element**: `parallel_for` with a grain of 1 on a million cheap elements spends its time creating tasks. Let the pool choose the grain, or choose one that gives each task at least a few microseconds of work.
+
+3. **Stealing from the wrong end**: If thieves took the newest task, they would compete with the owner at the same end of the deque, and they would get the smallest pieces of work. The owner works at the bottom and thieves take from the top.
+
+4. **Freeing the old array while growing**: A thief may have loaded the pointer to the old array just before the owner replaced it. Deleting the old array at that point makes the thief read freed memory. Keep it until no thief can reach it; here, until the deque is destroyed.
+
+5. **Returning before the forked task finishes**: The `JoinTask` and the variables its function captures by reference live on the stack of `fork_join`. Returning early, for example because `a` threw, would leave a thief running on a dead stack frame. Wait for `b` first, then rethrow.
+
+6. **A non-associative reduce**: `parallel_reduce` combines partial results in an order that depends on the grain and the number of workers. With floating-point addition, the result can differ in the last bits from a serial loop, and with an operation that is not associative at all, it is simply wrong.
+
+7. **Pinning more threads than cores**: Two workers pinned to the same CPU can never run in parallel, even if other CPUs are idle. Only pin when the pool has at most one thread per core and the machine is not shared.
@@ -0,0 +1,287 @@
+```cpp
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <thread>
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
+#include <random>
+#include <chrono>
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+
+// Keeps the K largest items of a stream in a fixed-capacity min-heap. The
+// heap's root is the smallest item still in the top K, so any new item that
+// is not larger than the root can be rejected with a single comparison.
+template <typename T, typename Compare = std::less<T>>
+class TopK {
+public:
+    explicit TopK(std::size_t k, Compare compare = Compare()) : capacity(k), less(compare) {
+        if (k == 0) {
+            throw std::invalid_argument("TopK needs a capacity of at least one");
+        }
+        heap.reserve(k);
+    }
+
+    std::size_t size() const { return heap.size(); }
+    bool full() const { return heap.size() == capacity; }
+
+    // Function to return the smallest item currently kept (the admission threshold)
+    const T& threshold() const {
+        if (heap.empty()) {
+            throw std::out_of_range("TopK is empty");
+        }
+        return heap[0];
+    }
+
+    // Function to offer a single item
+    void offer(const T& item) {
+        if (!full()) {
+            insert(item);
+        } else if (less(heap[0], item)) {
+            replaceTop(item);
+        }
+    }
+
+    // Function to offer a batch of items. Once the heap is full, items are
+    // compared against the threshold 64 at a time into a bitmask; this loop
+    // has no data-dependent branches, so the compiler can vectorize it and
+    // the scan runs at close to memory speed when almost everything is
+    // rejected. Only the set bits ever touch the heap.
+    void offer(const T* items, std::size_t count) {
+        std::size_t i = 0;
+        for (; i < count && !full(); ++i) {
+            insert(items[i]);
+        }
+
+        constexpr std::size_t block = 64;
+        for (; i + block <= count; i += block) {
+            const T limit = heap[0];
+            std::uint64_t candidates = 0;
+            for (std::size_t j = 0; j < block; ++j) {
+                candidates |= static_cast<std::uint64_t>(less(limit, items[i + j])) << j;
+            }
+            while (candidates != 0) {
+                std::size_t j = static_cast<std::size_t>(std::countr_zero(candidates));
+                candidates &= candidates - 1;
+                if (less(heap[0], items[i + j])) { // the threshold may have risen
+                    replaceTop(items[i + j]);
+                }
+            }
+        }
+        for (; i < count; ++i) {
+            offer(items[i]);
+        }
+    }
+
+    void offer(const std::vector<T>& items) {
+        offer(items.data(), items.size());
+    }
+
+    // Function to combine another selector's results into this one, e.g. at
+    // the end of a parallel reduction where every thread owns a TopK.
+    void merge(const TopK& other) {
+        offer(other.heap.data(), other.heap.size());
+    }
+
+    // Function to return the kept items, largest first
+    std::vector<T> sorted() const {
+        std::vector<T> result = heap;
+        std::sort(result.begin(), result.end(), [this](const T& a, const T& b) { return less(b, a); });
+        return result;
+    }
+
+private:
+    std::size_t capacity;
+    std::vector<T> heap;
+    Compare less;
+
+    void insert(const T& item) {
+        heap.push_back(item);
+        std::size_t index = heap.size() - 1;
+        T hole = std::move(heap[index]);
+        while (index > 0 && less(hole, heap[(index - 1) / 2])) {
+            heap[index] = std::move(heap[(index - 1) / 2]);
+            index = (index - 1) / 2;
+        }
+        heap[index] = std::move(hole);
+    }
+
+    // Overwrite the root and sift the hole down; the heap never grows past K
+    void replaceTop(const T& item) {
+        const std::size_t count = heap.size();
+        std::size_t index = 0;
+        while (true) {
+            std::size_t child = 2 * index + 1;
+            if (child >= count) {
+                break;
+            }
+            if (child + 1 < count && less(heap[child + 1], heap[child])) {
+                ++child;
+            }
+            if (!less(heap[child], item)) {
+                break;
+            }
+            heap[index] = std::move(heap[child]);
+            index = child;
+        }
+        heap[index] = item;
+    }
+};
+
+// Parallel reduction: each thread selects from its own slice, then the
+// per-thread selectors are merged into the first one.
+template <typename T>
+TopK<T> parallelTopK(const std::vector<T>& items, std::size_t k, std::size_t threads) {
+    std::vector<TopK<T>> partial(threads, TopK<T>(k));
+    std::vector<std::thread> workers;
+    std::size_t chunk = (items.size() + threads - 1) / threads;
+    for (std::size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::size_t begin = std::min(items.size(), t * chunk);
+            std::size_t end = std::min(items.size(), begin + chunk);
+            partial[t].offer(items.data() + begin, end - begin);
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (std::size_t t = 1; t < threads; ++t) {
+        partial[0].merge(partial[t]);
+    }
+    return partial[0];
+}
+
+template <typename Function>
+double timeMs(Function run) {
+    auto start = std::chrono::steady_clock::now();
+    run();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+int main(int argc, char* argv[]) {
+    TopK<int> topThree(3);
+    topThree.offer(std::vector<int>{5, 1, 9, 3, 7, 2, 8});
+    std::cout << "Top 3 of {5, 1, 9, 3, 7, 2, 8}:";
+    for (int value : topThree.sorted()) {
+        std::cout << " " << value;
+    }
+    std::cout << std::endl;
+
+    std::size_t events = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000;
+    const std::size_t k = 1000;
+    std::vector<float> scores(events);
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> score(0.0f, 1.0f);
+    for (float& value : scores) {
+        value = score(rng);
+    }
+    const double gigabytes = static_cast<double>(events * sizeof(float)) / 1e9;
+    std::cout << "\nTop " << k << " of " << events << " scores (" << gigabytes << " GB)" << std::endl;
+
+    std::vector<float> expected;
+    double heapAllMs = timeMs([&] {
+        std::priority_queue<float> everything(scores.begin(), scores.end());
+        // With fewer events than k, every event is in the top k
+        for (std::size_t i = 0; i < std::min(k, events); ++i) {
+            expected.push_back(everything.top());
+            everything.pop();
+        }
+    });
+
+    // Reading every score once with a trivially vectorizable loop shows how
+    // fast this machine can stream the data from memory.
+    std::ptrdiff_t above = 0;
+    double scanMs = timeMs([&] { above = std::count_if(scores.begin(), scores.end(), [](float v) { return v > 1.0f; }); });
+
+    std::vector<float> single;
+    double singleMs = timeMs([&] {
+        TopK<float> top(k);
+        for (float value : scores) {
+            top.offer(value);
+        }
+        single = top.sorted();
+    });
+
+    std::vector<float> batched;
+    double batchMs = timeMs([&] {
+        TopK<float> top(k);
+        top.offer(scores);
+        batched = top.sorted();
+    });
+
+    std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<float> parallel;
+    double parallelMs = timeMs([&] { parallel = parallelTopK(scores, k, threads).sorted(); });
+
+    auto report = [&](const char* name, double ms, const std::vector<float>* result) {
+        std::cout << name << ms << " ms, " << gigabytes / (ms / 1000.0) << " GB/s";
+        if (result != nullptr && *result != expected) {
+            std::cout << "  [MISMATCH]";
+        }
+        std::cout << std::endl;
+    };
+    report("heap of everything:    ", heapAllMs, nullptr);
+    report("plain scan (bandwidth):", scanMs, nullptr);
+    report("offer one by one:      ", singleMs, &single);
+    report("offer in batches:      ", batchMs, &batched);
+    std::cout << threads << " thread(s) + merge:   ";
+    report("", parallelMs, &parallel);
+    std::cout << "(scan found " << above << " scores above 1.0)" << std::endl;
+
+    return 0;
+}
+```
+
+This C++ code implements a Top-K selector: it reads a stream of items once and keeps only the K largest. It replaces the approach of inserting every event into a heap and calling `deleteMin` (see `Heap.cpp`) until the interesting items come out, which stores the whole stream in memory.
+
+The code is divided into three main parts:
+
+1. The `TopK` class template: A min-heap that never holds more than K items. Its root is the smallest item that is still in the top K, so it doubles as the admission threshold for new items.
+
+2. `parallelTopK`: Splits the input into one slice per thread, runs a separate `TopK` on each slice, and merges the partial results into one selector at the end.
+
+3. The main function: A small example, followed by a benchmark that finds the top 1000 of 100 million random scores in several ways. A plain `std::count_if` over the same array is timed as well, because it shows how fast the machine can stream the data from memory. Compile with optimizations, for example `g++ -std=c++20 -O3 -march=native`, so the batch loop is vectorized. The number of scores can be passed as the first command line argument.
+
+This code matters for several reasons:
+
+1. **Memory**: Only K items are stored, no matter how long the stream is. A heap of the whole stream needs memory proportional to the input.
+
+2. **Speed when most items are rejected**: In a long random stream, after the first few thousand items almost every new item is smaller than the threshold. Rejecting such an item costs one comparison and never touches the heap, so the selector spends its time reading input rather than reorganizing the heap.
+
+3. **Batch processing**: The batch `offer` compares 64 items at a time against the threshold and collects the results in a bitmask. This loop has no branches that depend on the data, so the compiler can turn it into SIMD instructions, and the scan comes close to memory bandwidth.
+
+4. **Parallel reduction**: Each thread works on its own selector without any locking. Merging two selectors is just offering the K items of one to the other.
+
+Here's a breakdown of the concepts used in the code:
+
+1. `template <typename T, typename Compare = std::less<T>>`: Any type with an ordering can be selected. With the default `std::less<T>` the selector keeps the largest items; with `std::greater<T>` it keeps the smallest.
+
+2. `offer(const T& item)`: Inserts the item while the heap has fewer than K items. After that, the item is only accepted if it is larger than the root, and it then replaces the root.
+
+3. `replaceTop(item)`: Instead of a `deleteMin` followed by an `insert`, the new item is sifted down from the root in one pass. The heap stays at exactly K items and never reallocates.
+
+4. `offer(const T* items, std::size_t count)`: The batch version. `candidates` is a 64-bit mask where bit j is set when item j of the block beats the threshold. `std::countr_zero` finds the next set bit and `candidates &= candidates - 1` clears it. Because the threshold can rise while a block is processed, each candidate is checked again before it is inserted.
+
+5. `merge(other)`: Feeds the other selector's items through the batch `offer`, so merging costs O(K log K).
+
+6. `sorted()`: Copies the kept items and sorts them from largest to smallest with a lambda that reverses the comparison.
+
+7. `timeMs`: A small helper that times any callable with `std::chrono::steady_clock`.
+
+Here are some common beginner mistakes to avoid with Top-K selection:
+
+1. **Using a max-heap for the largest items**: To keep the K largest, you need quick access to the smallest of them, because that is the item to throw out. That means a min-heap of size K.
+
+2. **Storing the whole stream**: Pushing every item into a heap or vector and sorting it afterwards works for small inputs but runs out of memory for long streams.
+
+3. **Pop-then-push**: Removing the root and then inserting the new item costs two sifts. Replacing the root and sifting once is about twice as fast.
+
+4. **Forgetting the threshold can change**: Inside the batch loop the threshold rises as better items are accepted. Using a stale threshold without re-checking would let items into the heap that no longer belong there.
+
+5. **Sharing one selector between threads**: Protecting a single selector with a mutex serializes the threads. Giving each thread its own selector and merging at the end needs no synchronization at all.
+
+6. **Comparing against the wrong baseline**: Throughput numbers only mean something next to what the hardware can do. Timing a plain scan over the same data shows how close the selector gets to memory bandwidth. A floating-point sum is a poor reference, because the compiler may not reorder the additions and therefore cannot vectorize it.
@@ -71,6 +71,46 @@ function App() {
             difficulty: 'Advanced',
             category: 'Concurrency',
           },
+          {
+            name: 'Concurrent Priority Queue',
+            path: '/cpp-scripts/ConcurrentPriorityQueue.cpp',
+            content: '',
+            timeSpent: 2,
+            difficulty: 'Advanced',
+            category: 'Concurrency',
+          },
+          {
+            name: 'Concurrent Map',
+            path: '/cpp-scripts/ConcurrentMap.cpp',
+            content: '',
+            timeSpent: 2,
+            difficulty: 'Advanced',
+            category: 'Concurrency',
+          },
+          {
+            name: 'Lock-Free Linked List',
+            path: '/cpp-scripts/LockFreeLinkedList.cpp',
+            content: '',
+            timeSpent: 2,
+            difficulty: 'Advanced',
+            category: 'Concurrency',
+          },
+          {
+            name: 'Thread Pool',
+            path: '/cpp-scripts/ThreadPool.cpp',
+            content: '',
+            timeSpent: 2,
+            difficulty: 'Advanced',
+            category: 'Concurrency',
+          },
+          {
+            name: 'Coroutines',
+            path: '/cpp-scripts/Coroutines.cpp',
+            content: '',
+            timeSpent: 2,
+            difficulty: 'Advanced',
+            category: 'Concurrency',
+          },
           {
             name: 'Constructors and Destructors',
             path: '/cpp-scripts/ConstructorsAndDestructors.cpp',
@@ -207,6 +247,30 @@ function App() {
             difficulty: 'Intermediate',
             category: 'Data Structures',
           },
+          {
+            name: 'Persistent Map',
+            path: '/cpp-scripts/PersistentMap.cpp',
+            content: '',
+            timeSpent: 2,
+            difficulty: 'Advanced',
+            category: 'Data Structures',
+          },
+          {
+            name: 'Timer Wheel',
+            path: '/cpp-scripts/TimerWheel.cpp',
+            content: '',
+            timeSpent: 2,
+            difficulty: 'Advanced',
+            category: 'Data Structures',
+          },
+          {
+            name: 'Top K Selection',
+            path: '/cpp-scripts/TopK.cpp',
+            content: '',
+            timeSpent: 2,
+            difficulty: 'Advanced',
+            category: 'Algorithms',
+          },
           {
             name: 'Array',
             path: '/cpp-scripts/array.cpp',